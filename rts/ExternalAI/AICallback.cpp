@@ -808,19 +808,19 @@ static int FilterUnitsVector(const std::vector<CUnit*>& units, int* unitIds, int
 }
 
 
-static int myAllyTeamId = -1;
+static thread_local int myAllyTeamId = -1;
 
-/// You have to set myAllyTeamId before calling this function. NOT thread safe!
+/// You have to set myAllyTeamId (per thread) before calling this function.
 static inline bool unit_IsEnemy(const CUnit* unit) {
 	return (!teamHandler.Ally(unit->allyteam, myAllyTeamId) && !unit->IsNeutral());
 }
 
-/// You have to set myAllyTeamId before calling this function. NOT thread safe!
+/// You have to set myAllyTeamId (per thread) before calling this function.
 static inline bool unit_IsFriendly(const CUnit* unit) {
 	return (teamHandler.Ally(unit->allyteam, myAllyTeamId) && !unit->IsNeutral());
 }
 
-/// You have to set myAllyTeamId before calling this function. NOT thread safe!
+/// You have to set myAllyTeamId (per thread) before calling this function.
 static inline bool unit_IsInSensor(const CUnit* unit, const unsigned short losFlags) {
 	// Skip in-sensor-range test if the unit is allied with our team.
 	// This prevents errors where an allied unit is starting to build,
@@ -829,22 +829,22 @@ static inline bool unit_IsInSensor(const CUnit* unit, const unsigned short losFl
 	return (teamHandler.Ally(myAllyTeamId, unit->allyteam) || ((unit->losStatus[myAllyTeamId] & losFlags) != 0));
 }
 
-/// You have to set myAllyTeamId before calling this function. NOT thread safe!
+/// You have to set myAllyTeamId (per thread) before calling this function.
 static inline bool unit_IsInLos(const CUnit* unit) {
 	return unit_IsInSensor(unit, LOS_INLOS);
 }
 
-/// You have to set myAllyTeamId before calling this function. NOT thread safe!
+/// You have to set myAllyTeamId (per thread) before calling this function.
 static inline bool unit_IsEnemyAndInLos(const CUnit* unit) {
 	return (unit_IsEnemy(unit) && unit_IsInLos(unit));
 }
 
-/// You have to set myAllyTeamId before calling this function. NOT thread safe!
+/// You have to set myAllyTeamId (per thread) before calling this function.
 static inline bool unit_IsEnemyAndInLosOrRadar(const CUnit* unit) {
 	return (unit_IsEnemy(unit) && ((unit->losStatus[myAllyTeamId] & (LOS_INLOS | LOS_INRADAR)) != 0));
 }
 
-/// You have to set myAllyTeamId before calling this function. NOT thread safe!
+/// You have to set myAllyTeamId (per thread) before calling this function.
 static inline bool unit_IsNeutralAndInLosOrRadar(const CUnit* unit) {
 	return (unit->IsNeutral() && (unit_IsInSensor(unit, LOS_INLOS | LOS_INRADAR)));
 }
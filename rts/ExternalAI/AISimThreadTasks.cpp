@@ -0,0 +1,133 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "ExternalAI/AISimThreadTasks.h"
+#include "ExternalAI/SkirmishAIHandler.h"
+#include "System/Threading/SpringThreading.h"
+#include "System/Threading/ThreadPool.h"
+
+#include <deque>
+#include <future>
+#include <shared_mutex>
+
+// updates hold this shared while they run, tasks hold it exclusively
+static std::shared_mutex AI_WORLD_MUTEX;
+
+static spring::mutex AI_SIM_TASKS_MUTEX;
+static spring::condition_variable_any AI_SIM_TASKS_COND;
+static std::deque<std::function<void()>> AI_SIM_TASKS;
+static size_t AI_NUM_THREADED_UPDATES = 0;
+
+static thread_local bool AI_IN_THREADED_UPDATE = false;
+
+
+bool AISimThreadTasks::InThreadedUpdate() { return AI_IN_THREADED_UPDATE; }
+
+void AISimThreadTasks::RunOnSimThread(const std::function<void()>& func)
+{
+	if (!AI_IN_THREADED_UPDATE) {
+		func();
+		return;
+	}
+
+	// the current AI is tracked per thread, the sim thread has to act as
+	// this one's AI while running the task (e.g. to stamp its commands)
+	const uint8_t skirmishAIId = CSkirmishAIHandler::GetCurrentAIID();
+
+	std::packaged_task<void()> task([&func, skirmishAIId]() {
+		struct AIIDScope {
+			AIIDScope(uint8_t id): prevId(CSkirmishAIHandler::GetCurrentAIID()) { CSkirmishAIHandler::SetCurrentAIID(id); }
+			~AIIDScope() { CSkirmishAIHandler::SetCurrentAIID(prevId); }
+
+			uint8_t prevId;
+		} aiIdScope(skirmishAIId);
+
+		func();
+	});
+
+	auto result = task.get_future();
+
+	// let the sim thread take the exclusive lock while this one waits
+	AI_WORLD_MUTEX.unlock_shared();
+
+	{
+		std::lock_guard<spring::mutex> lock(AI_SIM_TASKS_MUTEX);
+		AI_SIM_TASKS.emplace_back([&task]() { task(); });
+	}
+
+	AI_SIM_TASKS_COND.notify_all();
+	result.wait();
+
+	AI_WORLD_MUTEX.lock_shared();
+	result.get();
+}
+
+void AISimThreadTasks::RunUpdates(const std::vector<std::function<void()>>& updates)
+{
+	// Enqueue would run each update right away on this thread anyway
+	if (!ThreadPool::HasThreads()) {
+		for (const std::function<void()>& update: updates) {
+			update();
+		}
+
+		return;
+	}
+
+	std::vector<std::shared_future<void>> results;
+	results.reserve(updates.size());
+
+	{
+		std::lock_guard<spring::mutex> lock(AI_SIM_TASKS_MUTEX);
+		AI_NUM_THREADED_UPDATES = updates.size();
+	}
+
+	for (const std::function<void()>& update: updates) {
+		results.emplace_back(ThreadPool::Enqueue([&update]() {
+			// counted as done on the way out, even if the update throws
+			struct UpdateScope {
+				UpdateScope() { AI_IN_THREADED_UPDATE = true; }
+				~UpdateScope() {
+					AI_IN_THREADED_UPDATE = false;
+
+					{
+						std::lock_guard<spring::mutex> lock(AI_SIM_TASKS_MUTEX);
+						AI_NUM_THREADED_UPDATES -= 1;
+					}
+
+					AI_SIM_TASKS_COND.notify_all();
+				}
+			} updateScope;
+
+			std::shared_lock<std::shared_mutex> worldLock(AI_WORLD_MUTEX);
+			update();
+		}));
+	}
+
+	// serve what the updates hand over until all of them are done
+	std::unique_lock<spring::mutex> lock(AI_SIM_TASKS_MUTEX);
+
+	while (true) {
+		AI_SIM_TASKS_COND.wait(lock, []() { return (!AI_SIM_TASKS.empty() || AI_NUM_THREADED_UPDATES == 0); });
+
+		if (AI_SIM_TASKS.empty())
+			break;
+
+		const std::function<void()> task = std::move(AI_SIM_TASKS.front());
+		AI_SIM_TASKS.pop_front();
+
+		lock.unlock();
+
+		{
+			std::unique_lock<std::shared_mutex> worldLock(AI_WORLD_MUTEX);
+			task();
+		}
+
+		lock.lock();
+	}
+
+	lock.unlock();
+
+	// rethrows whatever an update threw
+	for (const std::shared_future<void>& result: results) {
+		result.get();
+	}
+}
@@ -0,0 +1,31 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef AI_SIM_THREAD_TASKS_H
+#define AI_SIM_THREAD_TASKS_H
+
+#include <functional>
+#include <vector>
+
+/**
+ * Threaded Skirmish AI updates (see AIThreadedUpdate).
+ * While the updates run on the worker threads they only read the world;
+ * anything which changes engine state, reaches the log sinks or calls into
+ * Lua is handed to the sim thread and runs there, one task at a time and
+ * on behalf of the AI (CSkirmishAIHandler::GetCurrentAIID) that sent it.
+ */
+namespace AISimThreadTasks {
+	/// true on a worker thread while it runs one of the updates
+	bool InThreadedUpdate();
+
+	/// runs func directly unless InThreadedUpdate, else returns once it has run on the sim thread
+	void RunOnSimThread(const std::function<void()>& func);
+
+	/**
+	 * Runs the updates in parallel on the worker threads and executes the
+	 * tasks they hand over on the calling (sim) thread until all are done.
+	 * Rethrows whatever an update threw.
+	 */
+	void RunUpdates(const std::vector<std::function<void()>>& updates);
+}
+
+#endif // AI_SIM_THREAD_TASKS_H
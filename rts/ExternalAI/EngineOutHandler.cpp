@@ -5,6 +5,7 @@
 #include "ExternalAI/SkirmishAIWrapper.h"
 #include "ExternalAI/SkirmishAIData.h"
 #include "ExternalAI/SkirmishAIHandler.h"
+#include "ExternalAI/SSkirmishAICallbackImpl.h"
 #include "ExternalAI/AILibraryManager.h"
 #include "ExternalAI/Interface/AISCommands.h"
 #include "Game/GlobalUnsynced.h"
@@ -19,6 +20,7 @@
 #include "Sim/Units/CommandAI/Command.h"
 #include "Sim/Weapons/WeaponDef.h"
 #include "Net/Protocol/NetProtocol.h"
+#include "System/Config/ConfigHandler.h"
 #include "System/Log/ILog.h"
 #include "System/TimeProfiler.h"
 #include "System/SafeUtil.h"
@@ -29,6 +31,8 @@ CR_REG_METADATA(CEngineOutHandler, (
 	CR_IGNORED(hostSkirmishAIs),
 	CR_IGNORED(teamSkirmishAIs),
 	CR_IGNORED(activeSkirmishAIs),
+	CR_IGNORED(threadedSkirmishAIs),
+	CR_IGNORED(threadedUpdate),
 
 	CR_POSTLOAD(PostLoad)
 ))
@@ -44,6 +48,8 @@ static inline bool IsUnitInLosOrRadarOfAllyTeam(const CUnit& unit, const int all
 	return (losHandler->GetGlobalLOS(allyTeamId) || (unit.losStatus[allyTeamId] & (LOS_INLOS | LOS_INRADAR)));
 }
 
+CONFIG(bool, AIThreadedUpdate).defaultValue(false).description("Run the per-frame Update of native Skirmish AIs which opt in through their AIInfo (threadedUpdateSupported) on the worker threads, in parallel with each other. The world does not change while they run; their commands, log messages and Lua calls are executed on the simulation thread, one at a time.");
+
 static CEngineOutHandler singleton;
 static unsigned int numInstances = 0;
 
@@ -76,6 +82,14 @@ void CEngineOutHandler::Destroy() {
 }
 
 
+void CEngineOutHandler::Init() {
+	activeSkirmishAIs.reserve(16);
+	threadedSkirmishAIs.reserve(16);
+
+	threadedUpdate = configHandler->GetBool("AIThreadedUpdate");
+}
+
+
 // This macro should be inserted at the start of each method sending AI events
 #define AI_SCOPED_TIMER()           \
 	if (activeSkirmishAIs.empty())  \
@@ -127,7 +141,27 @@ void CEngineOutHandler::Save(std::ostream* s, const uint8_t skirmishAIId) {
 
 void CEngineOutHandler::Update() {
 	AI_SCOPED_TIMER();
-	DO_FOR_SKIRMISH_AIS(Update(gs->frameNum))
+
+	if (!threadedUpdate) {
+		DO_FOR_SKIRMISH_AIS(Update(gs->frameNum))
+		return;
+	}
+
+	threadedSkirmishAIs.clear();
+
+	// the rest run first and alone, they may change the world
+	for (uint8_t aiID: activeSkirmishAIs) {
+		CSkirmishAIWrapper& ai = hostSkirmishAIs[aiID];
+
+		if (ai.IsThreadedUpdateSupported()) {
+			threadedSkirmishAIs.push_back(&ai);
+		} else {
+			ai.Update(gs->frameNum);
+		}
+	}
+
+	// the sim thread blocks until all are done, so every AI reads the same frame
+	skirmishAiCallback_UpdateThreaded(threadedSkirmishAIs, gs->frameNum);
 }
 
 
@@ -31,7 +31,7 @@ public:
 	static void Create();
 	static void Destroy();
 
-	void Init() { activeSkirmishAIs.reserve(16); }
+	void Init();
 	void Kill() {
 		PreDestroy();
 
@@ -117,6 +117,10 @@ private:
 	std::array<std::vector<uint8_t>, MAX_TEAMS> teamSkirmishAIs;
 
 	std::vector<uint8_t> activeSkirmishAIs;
+	/// AIs whose Update runs on the worker threads this frame
+	std::vector<CSkirmishAIWrapper*> threadedSkirmishAIs;
+
+	bool threadedUpdate = false;
 };
 
 #define eoh CEngineOutHandler::GetInstance()
@@ -10,6 +10,29 @@ extern "C" {
 #endif
 
 
+/**
+ * Layout of one unit record as filled in by the bulk unit-state callbacks
+ * (getUnitStates, getEnemyUnitStatesIn, getFriendlyUnitStatesIn).
+ * Each record is UNIT_STATE_SIZE floats; integer values (IDs) are stored
+ * as exact floats, values the AI can not see are -1.
+ */
+enum UnitStateField {
+	UNIT_STATE_ID             =  0,
+	UNIT_STATE_DEF            =  1,
+	UNIT_STATE_TEAM           =  2,
+	UNIT_STATE_HEALTH         =  3,
+	UNIT_STATE_MAX_HEALTH     =  4,
+	UNIT_STATE_BUILD_PROGRESS =  5,
+	UNIT_STATE_POS_X          =  6,
+	UNIT_STATE_POS_Y          =  7,
+	UNIT_STATE_POS_Z          =  8,
+	UNIT_STATE_VEL_X          =  9,
+	UNIT_STATE_VEL_Y          = 10,
+	UNIT_STATE_VEL_Z          = 11,
+	UNIT_STATE_SIZE           = 12,
+};
+
+
 /**
  * @brief Skirmish AI Callback function pointers.
  * Each Skirmish AI instance will receive an instance of this struct
@@ -2256,6 +2279,28 @@ struct SSkirmishAICallback {
 
 	bool              (CALLING_CONV *Debug_GraphDrawer_isEnabled)(int skirmishAIId);
 
+	/**
+	 * Bulk version of the Unit_get* callbacks: writes one UnitStateField
+	 * record per unit of unitIds that is in LOS or radar into states, with
+	 * the sensor checks done once per unit instead of once per value.
+	 * Units the AI can not see (or that do not exist) are skipped.
+	 * Pass states = NULL to query the required size.
+	 * @return number of floats written (records * UNIT_STATE_SIZE)
+	 */
+	int               (CALLING_CONV *getUnitStates)(int skirmishAIId, int* unitIds, int unitIds_size, float* states, int states_sizeMax); //$ ARRAY:states
+
+	/**
+	 * Same as getEnemyUnitsIn, but returns a UnitStateField record per unit.
+	 * @see getUnitStates
+	 */
+	int               (CALLING_CONV *getEnemyUnitStatesIn)(int skirmishAIId, float* pos_posF3, float radius, bool spherical, float* states, int states_sizeMax); //$ ARRAY:states
+
+	/**
+	 * Same as getFriendlyUnitsIn, but returns a UnitStateField record per unit.
+	 * @see getUnitStates
+	 */
+	int               (CALLING_CONV *getFriendlyUnitStatesIn)(int skirmishAIId, float* pos_posF3, float radius, bool spherical, float* states, int states_sizeMax); //$ ARRAY:states
+
 };
 
 #if	defined(__cplusplus)
@@ -56,6 +56,14 @@ extern "C" {
 /** [bool: "yes" | "no"] */
 #define SKIRMISH_AI_PROPERTY_LOAD_SUPPORTED          "loadSupported"
 
+/**
+ * [bool: "yes" | "no"]
+ * Whether the Update event of this AI may be sent from a worker thread,
+ * concurrently with other AIs (see the AIThreadedUpdate config setting).
+ * Only set this if several instances of the AI can run in parallel.
+ */
+#define SKIRMISH_AI_PROPERTY_THREADED_UPDATE_SUPPORTED "threadedUpdateSupported"
+
 /**
  * [int]
  * The engine version number the AI was compiled for,
@@ -3,6 +3,7 @@
 #include "ExternalAI/AICallback.h"
 #include "ExternalAI/AICheats.h"
 #include "ExternalAI/AILibraryManager.h"
+#include "ExternalAI/AISimThreadTasks.h"
 #include "ExternalAI/SSkirmishAICallbackImpl.h"
 #include "ExternalAI/SkirmishAILibraryInfo.h"
 #include "ExternalAI/SkirmishAIWrapper.h"
@@ -47,6 +48,10 @@
 #include "System/SpringMath.h"
 #include "System/FileSystem/ArchiveScanner.h"
 #include "System/Log/ILog.h"
+#include "System/Threading/SpringThreading.h"
+
+#include <functional>
+#include <future>
 
 
 static std::array<std::pair<CAICallback, CAICheats>, MAX_AIS> AI_LEGACY_CALLBACKS;
@@ -62,10 +67,25 @@ static std::vector<LineMarker> AI_TMP_LINE_MARKERS[MAX_AIS];
 static constexpr size_t MAX_NUM_MARKERS = 16384;
 
 
+
 static inline CAICallback* GetCallBack(int skirmishAIId) { return &AI_LEGACY_CALLBACKS[skirmishAIId].first; }
 static inline CAICheats* GetCheatCallBack(int skirmishAIId) { return &AI_LEGACY_CALLBACKS[skirmishAIId].second; }
 
 
+// runs func on the sim thread if called from a threaded AI update, else directly
+template<typename F>
+static std::invoke_result_t<F> RunOnSimThread(F&& func) {
+	if (!AISimThreadTasks::InThreadedUpdate())
+		return func();
+
+	std::packaged_task<std::invoke_result_t<F>()> task(std::forward<F>(func));
+	auto result = task.get_future();
+
+	AISimThreadTasks::RunOnSimThread([&task]() { task(); });
+	return result.get();
+}
+
+
 static void CheckSkirmishAIId(int skirmishAIId, const char* caller) {
 	if (skirmishAIId >= 0 && skirmishAIId < MAX_AIS)
 		return;
@@ -640,11 +660,18 @@ EXPORT(int) skirmishAiCallback_Engine_executeCommand(
 
 EXPORT(int) skirmishAiCallback_Engine_handleCommand(
 	int skirmishAIId,
-	int /*toId*/,
+	int toId,
 	int commandId,
 	int commandTopic,
 	void* commandData
 ) {
+	if (AISimThreadTasks::InThreadedUpdate()) {
+		// commands change engine state and may call into Lua (LuaRules, LuaUI)
+		return RunOnSimThread([=]() {
+			return skirmishAiCallback_Engine_handleCommand(skirmishAIId, toId, commandId, commandTopic, commandData);
+		});
+	}
+
 	int ret = 0;
 
 	CAICallback* clb = GetCallBack(skirmishAIId);
@@ -1320,6 +1347,12 @@ EXPORT(const char*) skirmishAiCallback_SkirmishAI_OptionValues_getValueByKey(int
 EXPORT(void) skirmishAiCallback_Log_log(int skirmishAIId, const char* const msg) {
 	CheckSkirmishAIId(skirmishAIId, __func__);
 
+	// log sinks are not thread-safe
+	if (AISimThreadTasks::InThreadedUpdate()) {
+		RunOnSimThread([=]() { skirmishAiCallback_Log_log(skirmishAIId, msg); });
+		return;
+	}
+
 	const CSkirmishAILibraryInfo* info = getSkirmishAILibraryInfo(skirmishAIId);
 	const std::string& aiName = info->GetName();
 	const std::string& aiVersion = info->GetVersion();
@@ -1329,6 +1362,11 @@ EXPORT(void) skirmishAiCallback_Log_log(int skirmishAIId, const char* const msg)
 EXPORT(void) skirmishAiCallback_Log_exception(int skirmishAIId, const char* const msg, int severity, bool die) {
 	CheckSkirmishAIId(skirmishAIId, __func__);
 
+	if (AISimThreadTasks::InThreadedUpdate()) {
+		RunOnSimThread([=]() { skirmishAiCallback_Log_exception(skirmishAIId, msg, severity, die); });
+		return;
+	}
+
 	const CSkirmishAILibraryInfo* info = getSkirmishAILibraryInfo(skirmishAIId);
 	const char* aiName = (info->GetName()).c_str();
 	const char* aiVersion = (info->GetVersion()).c_str();
@@ -1396,6 +1434,10 @@ EXPORT(const char*) skirmishAiCallback_DataDirs_getWriteableDir(int skirmishAIId
 	CheckSkirmishAIId(skirmishAIId, __func__);
 
 	static std::vector<std::string> writeableDataDirs;
+	static spring::mutex writeableDataDirsMutex;
+
+	// threaded AI updates may call this concurrently
+	std::lock_guard<spring::mutex> lock(writeableDataDirsMutex);
 
 	// fill up writeableDataDirs until teamId index is in there
 	// if it is not yet
@@ -1429,6 +1471,9 @@ EXPORT(bool) skirmishAiCallback_Cheats_isEnabled(int skirmishAIId) {
 
 EXPORT(bool) skirmishAiCallback_Cheats_setEnabled(int skirmishAIId, bool enabled)
 {
+	if (AISimThreadTasks::InThreadedUpdate())
+		return RunOnSimThread([=]() { return skirmishAiCallback_Cheats_setEnabled(skirmishAIId, enabled); });
+
 	if ((AI_CHEAT_FLAGS[skirmishAIId].first = enabled) && !AI_CHEAT_FLAGS[skirmishAIId].second) {
 		LOG("[%s] SkirmishAI (id %i, team %i) is using cheats!", __func__, skirmishAIId, AI_TEAM_IDS[skirmishAIId]);
 		AI_CHEAT_FLAGS[skirmishAIId].second = true;
@@ -3858,6 +3903,110 @@ EXPORT(int) skirmishAiCallback_getTeamUnits(int skirmishAIId, int* unitIds, int
 }
 
 
+// fills one UnitStateField record with what Unit_get* would return for <unit>,
+// returns false (and leaves <state> untouched) if the unit is not visible at all
+static bool fillUnitState(int skirmishAIId, const CUnit* unit, float* state) {
+	const bool cheating = skirmishAiCallback_Cheats_isEnabled(skirmishAIId);
+
+	const int teamId = AI_TEAM_IDS[skirmishAIId];
+	const int allyId = teamHandler.AllyTeam(teamId);
+
+	const unsigned short losStatus = unit->losStatus[allyId];
+	const unsigned short prevMask = (LOS_PREVLOS | LOS_CONTRADAR);
+
+	const bool allied = (cheating || teamHandler.AlliedTeams(unit->team, teamId));
+	const bool inLos = (allied || (losStatus & LOS_INLOS) != 0);
+
+	if (!inLos && (losStatus & LOS_INRADAR) == 0)
+		return false;
+
+	const UnitDef* unitDef = unit->unitDef;
+	const UnitDef* shownDef = (allied || unitDef->decoyDef == nullptr)? unitDef: unitDef->decoyDef;
+	// decoys show the health of the unit they pretend to be
+	const float healthScale = shownDef->health / unitDef->health;
+
+	const float3 pos = cheating? unit->midPos: unit->GetErrorPos(allyId);
+	const bool typed = (inLos || (losStatus & prevMask) == prevMask);
+
+	state[UNIT_STATE_ID            ] = unit->id;
+	state[UNIT_STATE_DEF           ] = typed? shownDef->id: -1.0f;
+	state[UNIT_STATE_TEAM          ] = inLos? unit->team: -1.0f;
+	state[UNIT_STATE_HEALTH        ] = inLos? unit->health * healthScale: -1.0f;
+	state[UNIT_STATE_MAX_HEALTH    ] = inLos? unit->maxHealth * healthScale: -1.0f;
+	state[UNIT_STATE_BUILD_PROGRESS] = inLos? unit->buildProgress: -1.0f;
+	state[UNIT_STATE_POS_X         ] = pos.x;
+	state[UNIT_STATE_POS_Y         ] = pos.y;
+	state[UNIT_STATE_POS_Z         ] = pos.z;
+	state[UNIT_STATE_VEL_X         ] = unit->speed.x;
+	state[UNIT_STATE_VEL_Y         ] = unit->speed.y;
+	state[UNIT_STATE_VEL_Z         ] = unit->speed.z;
+	return true;
+}
+
+template<typename UnitContainer, typename UnitFilter>
+static int fillUnitStates(int skirmishAIId, const UnitContainer& units, const UnitFilter& includeUnit, float* states, int statesMaxSize) {
+	float tmpState[UNIT_STATE_SIZE];
+	int numFloats = 0;
+
+	for (const CUnit* unit: units) {
+		if (unit == nullptr || !includeUnit(unit))
+			continue;
+
+		if (states != nullptr && (numFloats + UNIT_STATE_SIZE) > statesMaxSize)
+			break;
+
+		if (!fillUnitState(skirmishAIId, unit, (states != nullptr)? &states[numFloats]: tmpState))
+			continue;
+
+		numFloats += UNIT_STATE_SIZE;
+	}
+
+	return numFloats;
+}
+
+EXPORT(int) skirmishAiCallback_getUnitStates(int skirmishAIId, int* unitIds, int unitIds_size, float* states, int states_sizeMax) {
+	std::vector<const CUnit*> units;
+	units.reserve(std::max(0, unitIds_size));
+
+	for (int i = 0; i < unitIds_size; i++) {
+		units.push_back(getUnit(unitIds[i]));
+	}
+
+	return fillUnitStates(skirmishAIId, units, [](const CUnit*) { return true; }, states, states_sizeMax);
+}
+
+EXPORT(int) skirmishAiCallback_getEnemyUnitStatesIn(int skirmishAIId, float* pos_posF3, float radius, bool spherical, float* states, int states_sizeMax) {
+	const int allyId = teamHandler.AllyTeam(AI_TEAM_IDS[skirmishAIId]);
+	const bool cheating = skirmishAiCallback_Cheats_isEnabled(skirmishAIId);
+
+	QuadFieldQuery qfQuery;
+	quadField.GetUnitsExact(qfQuery, pos_posF3, radius, spherical);
+
+	// enemies must be in LOS, as for getEnemyUnitsIn
+	const auto isEnemy = [&](const CUnit* unit) {
+		if (teamHandler.Ally(unit->allyteam, allyId) || unit->IsNeutral())
+			return false;
+
+		return (cheating || (unit->losStatus[allyId] & LOS_INLOS) != 0);
+	};
+
+	return fillUnitStates(skirmishAIId, *qfQuery.units, isEnemy, states, states_sizeMax);
+}
+
+EXPORT(int) skirmishAiCallback_getFriendlyUnitStatesIn(int skirmishAIId, float* pos_posF3, float radius, bool spherical, float* states, int states_sizeMax) {
+	const int allyId = teamHandler.AllyTeam(AI_TEAM_IDS[skirmishAIId]);
+
+	QuadFieldQuery qfQuery;
+	quadField.GetUnitsExact(qfQuery, pos_posF3, radius, spherical);
+
+	const auto isFriendly = [&](const CUnit* unit) {
+		return (teamHandler.Ally(unit->allyteam, allyId) && !unit->IsNeutral());
+	};
+
+	return fillUnitStates(skirmishAIId, *qfQuery.units, isFriendly, states, states_sizeMax);
+}
+
+
 //########### BEGIN Team
 EXPORT(bool) skirmishAiCallback_Team_hasAIController(int skirmishAIId, int teamId) {
 	// return (AI_TEAM_IDS[skirmishAIId] == teamId);
@@ -5525,6 +5674,9 @@ static void skirmishAiCallback_init(SSkirmishAICallback* callback) {
 	callback->Unit_Weapon_isShieldEnabled = &skirmishAiCallback_Unit_Weapon_isShieldEnabled;
 	callback->Unit_Weapon_getShieldPower = &skirmishAiCallback_Unit_Weapon_getShieldPower;
 	callback->Debug_GraphDrawer_isEnabled = &skirmishAiCallback_Debug_GraphDrawer_isEnabled;
+	callback->getUnitStates = &skirmishAiCallback_getUnitStates;
+	callback->getEnemyUnitStatesIn = &skirmishAiCallback_getEnemyUnitStatesIn;
+	callback->getFriendlyUnitStatesIn = &skirmishAiCallback_getFriendlyUnitStatesIn;
 }
 
 SSkirmishAICallback* skirmishAiCallback_GetInstance(CSkirmishAIWrapper* ai)
@@ -5553,3 +5705,19 @@ void skirmishAiCallback_BlockOrders(const CSkirmishAIWrapper* ai)
 	GetCallBack(ai->GetSkirmishAIID())->AllowOrders(false);
 }
 
+void skirmishAiCallback_RunOnSimThread(const std::function<void()>& func)
+{
+	RunOnSimThread(func);
+}
+
+void skirmishAiCallback_UpdateThreaded(const std::vector<CSkirmishAIWrapper*>& ais, int frame)
+{
+	std::vector<std::function<void()>> updates;
+	updates.reserve(ais.size());
+
+	for (CSkirmishAIWrapper* ai: ais) {
+		updates.emplace_back([ai, frame]() { ai->Update(frame); });
+	}
+
+	AISimThreadTasks::RunUpdates(updates);
+}
@@ -1263,6 +1263,12 @@ EXPORT(float            ) skirmishAiCallback_Unit_Weapon_getShieldPower(int skir
 
 EXPORT(bool             ) skirmishAiCallback_Debug_GraphDrawer_isEnabled(int skirmishAIId);
 
+EXPORT(int              ) skirmishAiCallback_getUnitStates(int skirmishAIId, int* unitIds, int unitIds_size, float* states, int states_sizeMax);
+
+EXPORT(int              ) skirmishAiCallback_getEnemyUnitStatesIn(int skirmishAIId, float* pos_posF3, float radius, bool spherical, float* states, int states_sizeMax);
+
+EXPORT(int              ) skirmishAiCallback_getFriendlyUnitStatesIn(int skirmishAIId, float* pos_posF3, float radius, bool spherical, float* states, int states_sizeMax);
+
 #if	defined(__cplusplus)
 } // extern "C"
 #endif
@@ -1270,6 +1276,9 @@ EXPORT(bool             ) skirmishAiCallback_Debug_GraphDrawer_isEnabled(int ski
 
 
 #if defined __cplusplus && !defined BUILDING_AI
+#include <functional>
+#include <vector>
+
 struct SSkirmishAICallback;
 class CSkirmishAIWrapper;
 class CAICallback;
@@ -1291,6 +1300,20 @@ void skirmishAiCallback_Release(const CSkirmishAIWrapper* ai);
 
 void skirmishAiCallback_BlockOrders(const CSkirmishAIWrapper* ai);
 
+/**
+ * Runs func on the sim thread when called from an AI update running on a
+ * worker thread (see skirmishAiCallback_UpdateThreaded), else directly.
+ */
+void skirmishAiCallback_RunOnSimThread(const std::function<void()>& func);
+
+/**
+ * Sends the Update event to the given AIs in parallel on the worker threads
+ * and returns when all of them are done. While they run the world does not
+ * change; commands, logging and Lua calls they make are executed on the
+ * calling (sim) thread, one at a time.
+ */
+void skirmishAiCallback_UpdateThreaded(const std::vector<CSkirmishAIWrapper*>& ais, int frame);
+
 #endif // defined __cplusplus && !defined BUILDING_AI
 
 
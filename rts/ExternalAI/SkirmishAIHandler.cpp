@@ -31,7 +31,6 @@ CR_REG_METADATA(CSkirmishAIHandler, (
 		CR_IGNORED(skirmishAIDataMap),
 		CR_IGNORED(luaAIShortNames),
 
-		CR_IGNORED(currentAIId),
 		CR_IGNORED(numSkirmishAIs),
 
 		CR_IGNORED(gameInitialized),
@@ -172,8 +172,8 @@ public:
 
 	const spring::unordered_set<std::string>& GetLuaAIImplShortNames() const { return luaAIShortNames; }
 
-	uint8_t GetCurrentAIID() { return currentAIId; }
-	void SetCurrentAIID(uint8_t id) { currentAIId = id; }
+	static uint8_t GetCurrentAIID() { return currentAIId; }
+	static void SetCurrentAIID(uint8_t id) { currentAIId = id; }
 
 private:
 	static bool IsLocalSkirmishAI(const SkirmishAIData& aiData);
@@ -200,8 +200,8 @@ private:
 	spring::unordered_map<uint8_t, const SkirmishAIData*> skirmishAIDataMap;
 	spring::unordered_set<std::string> luaAIShortNames;
 
-	// the current local AI ID that is executing, MAX_AIS if none (e.g. LuaUI)
-	uint8_t currentAIId = MAX_AIS;
+	// the current local AI ID that is executing on this thread, MAX_AIS if none (e.g. LuaUI)
+	static inline thread_local uint8_t currentAIId = MAX_AIS;
 	uint8_t numSkirmishAIs = 0;
 
 	bool gameInitialized = false;
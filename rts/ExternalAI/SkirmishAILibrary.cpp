@@ -3,6 +3,7 @@
 #include "SkirmishAILibrary.h"
 
 #include "ExternalAI/SkirmishAIHandler.h"
+#include "ExternalAI/SSkirmishAICallbackImpl.h"
 #include "ExternalAI/AIInterfaceKey.h"
 #include "Sim/Misc/GlobalConstants.h"
 #include "System/Log/ILog.h"
@@ -98,7 +99,8 @@ int CSkirmishAILibrary::HandleEvent(int skirmishAIId, int topic, const void* dat
 	const int teamId = skirmishAIHandler.GetSkirmishAI(skirmishAIId)->team;
 	const char* errorStr = "AI for team %d (ID: %d) failed handling event with topic %d, error: %d";
 
-	LOG_L(L_WARNING, errorStr, teamId, skirmishAIId, topic, ret);
+	// log sinks are not thread-safe, Update may run on a worker thread
+	skirmishAiCallback_RunOnSimThread([&]() { LOG_L(L_WARNING, errorStr, teamId, skirmishAIId, topic, ret); });
 
 	return ret;
 }
@@ -51,6 +51,8 @@ CR_REG_METADATA(CSkirmishAIWrapper, (
 
 	CR_MEMBER(cheatEvents),
 	CR_MEMBER(blockEvents),
+	// handled in InitLibrary
+	CR_IGNORED(threadedUpdate),
 
 	CR_SERIALIZER(Serialize),
 	CR_POSTLOAD(PostLoad)
@@ -117,6 +119,15 @@ bool CSkirmishAIWrapper::IsLoadSupported() const {
 	return loadSupported;
 }
 
+bool CSkirmishAIWrapper::IsThreadedUpdateSupported() const {
+	// cheat commands write to the simulation directly, and the Java
+	// interface can not be entered from threads its JVM does not know
+	if (!threadedUpdate || key.GetInterface().GetShortName() != "C")
+		return false;
+
+	return (!skirmishAiCallback_Cheats_isEnabled(skirmishAIId));
+}
+
 bool CSkirmishAIWrapper::InitLibrary() {
 	AILibraryManager* libManager = AILibraryManager::GetInstance();
 
@@ -133,6 +144,14 @@ bool CSkirmishAIWrapper::InitLibrary() {
 		return false;
 	}
 
+	{
+		// the library stays fetched until Kill, no need to do it again
+		const auto& libInfoMap = libManager->GetSkirmishAIInfos();
+		const auto& libInfoIt  = libInfoMap.find(key);
+
+		threadedUpdate = (libInfoIt != libInfoMap.end() && libInfoIt->second.GetInfo(SKIRMISH_AI_PROPERTY_THREADED_UPDATE_SUPPORTED) == "yes");
+	}
+
 	return true;
 }
 
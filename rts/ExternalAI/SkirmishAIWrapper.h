@@ -98,6 +98,12 @@ public:
 	bool Active() const { return (skirmishAIId != -1); }
 
 	bool IsLoadSupported() const;
+	/**
+	 * Whether the Update event may run on a worker thread, concurrently
+	 * with other AIs (native C interface AIs that do not cheat and set
+	 * SKIRMISH_AI_PROPERTY_THREADED_UPDATE_SUPPORTED in their AIInfo).
+	 */
+	bool IsThreadedUpdateSupported() const;
 
 private:
 	bool InitLibrary();
@@ -134,6 +140,7 @@ private:
 	bool libraryInit = false; // CSkirmishAILibrary::Init retval
 	bool cheatEvents = false;
 	bool blockEvents = false;
+	bool threadedUpdate = false; // AIInfo opt-in for threaded Update events
 };
 
 #endif // SKIRMISH_AI_WRAPPER_H
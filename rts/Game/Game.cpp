@@ -117,6 +117,7 @@
 #include "System/Exceptions.h"
 #include "System/Sync/FPUCheck.h"
 #include "System/SafeUtil.h"
+#include "System/ScratchArena.h"
 #include "System/SpringExitCode.h"
 #include "System/SpringMath.h"
 #include "System/FileSystem/FileSystem.h"
@@ -139,6 +140,9 @@
 
 CONFIG(bool, GameEndOnConnectionLoss).defaultValue(true);
 // CONFIG(bool, LuaCollectGarbageOnSimFrame).defaultValue(true);
+CONFIG(float, LuaGarbageCollectionFrameBudget).defaultValue(0.0f).minimumValue(0.0f).maximumValue(100.0f).description("Milliseconds per sim-frame that all Lua states together may spend on garbage collection, shared out by allocation rate and run between sim frames. 0 lets each state schedule its own collection.");
+
+CONFIG(int, DemoKeyFrameInterval).defaultValue(0).minimumValue(0).description("While watching a demo, write a savegame keyframe every this many game-minutes (0 disables). Loading a keyframe resumes the demo from its frame instead of re-simulating it from the start.");
 
 CONFIG(bool, ShowFPS).defaultValue(false).description("Displays current framerate.");
 CONFIG(bool, ShowClock).defaultValue(true).headlessValue(false).description("Displays a clock on the top-right corner of the screen showing the elapsed time of the current game.");
@@ -210,6 +214,9 @@ CR_REG_METADATA(CGame, (
 
 	CR_MEMBER(speedControl),
 	CR_MEMBER(luaGCControl),
+	CR_IGNORED(luaGCFrameBudget),
+	CR_IGNORED(luaGCBudgetFrameNum),
+	CR_IGNORED(demoKeyFrameInterval),
 
 	CR_IGNORED(jobDispatcher),
 	CR_IGNORED(curKeyCodeChain),
@@ -249,6 +256,8 @@ CGame::CGame(const std::string& mapFileName, const std::string& modFileName, ILo
 	showSpeed = configHandler->GetBool("ShowSpeed");
 
 	speedControl = configHandler->GetInt("SpeedControl");
+	luaGCFrameBudget = configHandler->GetFloat("LuaGarbageCollectionFrameBudget");
+	demoKeyFrameInterval = configHandler->GetInt("DemoKeyFrameInterval") * 60 * GAME_SPEED;
 
 	playerRoster.SetSortTypeByCode((PlayerRoster::SortType)configHandler->GetInt("ShowPlayerInfo"));
 
@@ -293,6 +302,8 @@ CGame::~CGame()
 	RmlGui::Shutdown();
 	helper->Kill();
 	KillLua(true);
+	// states surviving the game (LuaMenu) go back to scheduling their own gc
+	CLuaHandle::SetGarbageCollectBudget(0.0f);
 	KillMisc();
 	KillRendering();
 	KillInterface();
@@ -319,10 +330,23 @@ void CGame::AddTimedJobs()
 			const float simFrameDeltaTime = (spring_gettime() - lastSimFrameNetPacketTime).toMilliSecsf();
 			const float gcForcedDeltaTime = (5.0f * 1000.0f) / (GAME_SPEED * gs->speedFactor);
 
-			// SimFrame handles gc when not paused, this all other cases
-			// do not check the global synced state, never true in demos
-			if (luaGCControl == 1 || simFrameDeltaTime > gcForcedDeltaTime)
+			if (luaGCFrameBudget > 0.0f) {
+				// budgeted gc always runs here, i.e. in the idle time between
+				// sim frames; this job has a fixed rate so scale the budget by
+				// the number of sim frames that elapsed since it last ran (at
+				// least one while paused, at most as many as the unbudgeted gc
+				// speed factor allows while catching up)
+				const int numSimFrames = std::clamp(gs->frameNum - luaGCBudgetFrameNum, 1, 50);
+
+				luaGCBudgetFrameNum = gs->frameNum;
+
+				CLuaHandle::SetGarbageCollectBudget(luaGCFrameBudget * numSimFrames);
+				eventHandler.CollectGarbage(false);
+			} else if (luaGCControl == 1 || simFrameDeltaTime > gcForcedDeltaTime) {
+				// SimFrame handles gc when not paused, this all other cases
+				// do not check the global synced state, never true in demos
 				eventHandler.CollectGarbage(false);
+			}
 
 			CInputReceiver::CollectGarbage();
 			return true;
@@ -1806,7 +1830,7 @@ void CGame::SimFrame() {
 
 			// keep garbage-collection rate tied to sim-speed
 			// (fixed 30Hz gc is not enough while catching up)
-			if (luaGCControl == 0)
+			if (luaGCControl == 0 && luaGCFrameBudget <= 0.0f)
 				eventHandler.CollectGarbage(false);
 
 			eventHandler.GameFrame(gs->frameNum);
@@ -1843,6 +1867,9 @@ void CGame::SimFrame() {
 		teamHandler.GameFrame(gs->frameNum);
 		playerHandler.GameFrame(gs->frameNum);
 		eventHandler.GameFramePost(gs->frameNum);
+
+		// all sim temporaries are dead by now
+		spring::ScratchArena::ResetAll();
 	}
 
 	lastSimFrameTime = spring_gettime();
@@ -1869,6 +1896,11 @@ void CGame::SimFrame() {
 	// useful for desync-debugging (enter instead of -1 start & end frame of the range you want to debug)
 	DumpState(-1, -1, 1, std::nullopt);
 
+	// queue a keyframe, the save itself happens before the next Update
+	// (ClientReadNet stops reading packets while one is pending)
+	if (gameSetup->hostDemo && demoKeyFrameInterval > 0 && gs->frameNum > 0 && (gs->frameNum % demoKeyFrameInterval) == 0)
+		SaveDemoKeyFrame();
+
 	ASSERT_SYNCED(gsRNG.GetGenState());
 	LEAVE_SYNCED_CODE();
 }
@@ -2178,6 +2210,19 @@ void CGame::Save(std::string&& fileName, std::string&& saveArgs)
 	RECOIL_DETAILED_TRACY_ZONE;
 	globalSaveFileData.name = std::move(fileName);
 	globalSaveFileData.args = std::move(saveArgs);
+	globalSaveFileData.demoKeyFrame = false;
+}
+
+void CGame::SaveDemoKeyFrame()
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	// an explicit save request takes precedence
+	if (!globalSaveFileData.name.empty())
+		return;
+
+	globalSaveFileData.name = FileSystem::EnsurePathSepAtEnd("Saves") + FileSystem::GetBasename(gameSetup->demoName) + fmt::format("_f{:07d}.ssf", gs->frameNum);
+	globalSaveFileData.args = "-y";
+	globalSaveFileData.demoKeyFrame = true;
 }
 
 
@@ -100,6 +100,8 @@ public:
 	void ParseInputTextGeometry(const std::string& geo);
 
 	void Save(std::string&& fileName, std::string&& saveArgs);
+	/// save the sim-state while watching a demo, so it can be resumed from there
+	void SaveDemoKeyFrame();
 
 	void ResizeEvent() override;
 
@@ -209,6 +211,12 @@ public:
 
 	// 0 := 1/f rate, 1 := 30/s rate
 	int luaGCControl = 0;
+	// global per-frame Lua gc budget (ms), overrides luaGCControl if > 0
+	float luaGCFrameBudget = 0.0f;
+	// sim-frame at which the budget was last shared out
+	int luaGCBudgetFrameNum = 0;
+	// sim-frames between keyframe saves while watching a demo, 0 if disabled
+	int demoKeyFrameInterval = 0;
 
 private:
 	JobDispatcher jobDispatcher;
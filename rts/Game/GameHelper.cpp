@@ -219,33 +219,24 @@ void CGameHelper::DamageObjectsInExplosionRadius(
 	const int weaponDefID
 ) {
 	RECOIL_DETAILED_TRACY_ZONE;
-	static std::vector<CUnit*> unitCache;
-	static std::vector<CFeature*> featureCache;
+	// damaging can recursively trigger ::Explosion() again, every
+	// level gets its own lists and rewinds the arena on the way out
+	spring::ScratchArena::Scope scratchScope;
+	spring::scratch_vector<CUnit*> units;
+	spring::scratch_vector<CFeature*> features;
 
-	const unsigned int oldNumUnits = unitCache.size();
-	const unsigned int oldNumFeatures = featureCache.size();
+	units.reserve(64);
+	features.reserve(16);
 
-	quadField.GetUnitsAndFeaturesColVol(params.pos, expRad, unitCache, featureCache);
-
-	const unsigned int newNumUnits = unitCache.size();
-	const unsigned int newNumFeatures = featureCache.size();
+	quadField.GetUnitsAndFeaturesColVol(params.pos, expRad, units, features);
 
 	// damage all units within the explosion radius
-	// NOTE:
-	//   this can recursively trigger ::Explosion() again
-	//   which would overwrite our object cache if we did
-	//   not keep track of end-markers --> certain objects
-	//   would not be damaged AT ALL (!)
-	for (unsigned int n = oldNumUnits; n < newNumUnits; n++)
-		DoExplosionDamage(unitCache[n], params.owner, params.pos, expRad, params.explosionSpeed, params.edgeEffectiveness, params.ignoreOwner, params.damages, weaponDefID, params.projectileID);
-
-	unitCache.resize(oldNumUnits);
+	for (CUnit* unit: units)
+		DoExplosionDamage(unit, params.owner, params.pos, expRad, params.explosionSpeed, params.edgeEffectiveness, params.ignoreOwner, params.damages, weaponDefID, params.projectileID);
 
 	// damage all features within the explosion radius
-	for (unsigned int n = oldNumFeatures; n < newNumFeatures; n++)
-		DoExplosionDamage(featureCache[n], params.owner, params.pos, expRad, params.edgeEffectiveness, params.damages, weaponDefID, params.projectileID);
-
-	featureCache.resize(oldNumFeatures);
+	for (CFeature* feature: features)
+		DoExplosionDamage(feature, params.owner, params.pos, expRad, params.edgeEffectiveness, params.damages, weaponDefID, params.projectileID);
 }
 
 void CGameHelper::Explosion(const CExplosionParams& params) {
@@ -655,7 +646,7 @@ namespace {
 
 
 
-size_t CGameHelper::GenerateWeaponTargets(const CWeapon* weapon, const CUnit* avoidUnit, std::vector<std::pair<float, CUnit*>>& targets)
+size_t CGameHelper::GenerateWeaponTargets(const CWeapon* weapon, const CUnit* avoidUnit, spring::scratch_vector<std::pair<float, CUnit*>>& targets)
 {
 	const CUnit*  weaponOwner = weapon->owner;
 	const CUnit* lastAttacker = ((weaponOwner->lastAttackFrame + 200) <= gs->frameNum) ? weaponOwner->lastAttacker : nullptr;
@@ -7,6 +7,7 @@
 #include "Sim/Units/CommandAI/Command.h"
 #include "Sim/Misc/GlobalConstants.h"
 #include "System/EventClient.h"
+#include "System/ScratchArena.h"
 #include "System/float3.h"
 #include "System/float4.h"
 #include "System/type2.h"
@@ -148,7 +149,7 @@ public:
 		bool synced = false
 	);
 
-	static size_t GenerateWeaponTargets(const CWeapon* weapon, const CUnit* avoidUnit, std::vector<std::pair<float, CUnit*>>& targets);
+	static size_t GenerateWeaponTargets(const CWeapon* weapon, const CUnit* avoidUnit, spring::scratch_vector<std::pair<float, CUnit*>>& targets);
 
 	void Init();
 	void Kill();
@@ -207,7 +208,6 @@ private:
 
 public:
 	std::vector<int> targetUnitIDs; // GetEnemyUnits{NoLosTest}
-	std::vector<std::pair<float, CUnit*>> targetPairs; // GenerateWeaponTargets
 };
 
 extern CGameHelper* helper;
\ No newline at end of file
@@ -45,6 +45,7 @@ CR_REG_METADATA(CGameSetup, (
 	CR_IGNORED(gameStartDelay),
 
 	CR_IGNORED(numDemoPlayers),
+	CR_IGNORED(demoStartFrame),
 	CR_IGNORED(maxUnitsPerTeam),
 
 	CR_IGNORED(minSpeed),
@@ -197,6 +198,7 @@ void CGameSetup::ResetState()
 
 	gameStartDelay = 0;
 	numDemoPlayers = 0;
+	demoStartFrame = 0;
 	maxUnitsPerTeam = 0;
 
 	maxSpeed = 0.0f;
@@ -623,6 +625,7 @@ bool CGameSetup::Init(const std::string& buf)
 	hostDemo    = !demoName.empty();
 
 	file.GetTDef(gameStartDelay, 4u, "GAME\\GameStartDelay");
+	file.GetTDef(demoStartFrame, 0, "GAME\\DemoStartFrame");
 
 	file.GetDef(recordDemo,          "1", "GAME\\RecordDemo");
 	file.GetDef(useLuaGaia,          "1", "GAME\\ModOptions\\LuaGaia");
@@ -50,6 +50,7 @@ public:
 		gameStartDelay = gs.gameStartDelay;
 
 		numDemoPlayers = gs.numDemoPlayers;
+		demoStartFrame = gs.demoStartFrame;
 		maxUnitsPerTeam = gs.maxUnitsPerTeam;
 
 		maxSpeed = gs.maxSpeed;
@@ -204,6 +205,8 @@ public:
 	unsigned int gameStartDelay;
 
 	int numDemoPlayers;
+	/// frame a demo keyframe (savegame) resumes the demo from, 0 otherwise
+	int demoStartFrame;
 	int maxUnitsPerTeam;
 
 	float maxSpeed;
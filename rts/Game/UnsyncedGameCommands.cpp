@@ -91,6 +91,7 @@
 #include "Sim/MoveTypes/MoveDefHandler.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Sim/Misc/ModInfo.h"
+#include "Sim/Path/QTPFS/PathManager.h"
 #include "Sim/Projectiles/ProjectileHandler.h"
 #include "Sim/Units/UnitDef.h"
 #include "Sim/Units/UnitDefHandler.h"
@@ -2276,6 +2277,52 @@ public:
 	}
 };
 
+class PathSearchBenchActionExecutor : public IUnsyncedActionExecutor {
+public:
+	PathSearchBenchActionExecutor() : IUnsyncedActionExecutor("PathSearchBench", "Runs QTPFS searches between random points and logs their timings and memory footprint", false, {
+			{"<MoveDefName|MoveDefID> [searches] [seed]", "Benchmarks the node-layer of the given MoveDef (100 searches and seed 0 by default)"},
+			}) {
+	}
+
+	bool Execute(const UnsyncedAction& action) const final {
+		QTPFS::PathManager* pm = dynamic_cast<QTPFS::PathManager*>(pathManager);
+
+		if (pm == nullptr) {
+			LOG_L(L_WARNING, "/%s: only available with QTPFS", GetCommand().c_str());
+			return true;
+		}
+
+		const auto args = CSimpleParser::Tokenize(action.GetArgs());
+
+		if (args.empty()) {
+			LOG_L(L_WARNING, "/%s: wrong syntax", GetCommand().c_str());
+			return true;
+		}
+
+		bool failed = false;
+		unsigned int i = StringToInt(args[0], &failed);
+
+		if (failed)
+			i = -1;
+
+		const MoveDef* md = moveDefHandler.GetMoveDefByName(args[0]);
+
+		if (md == nullptr && i < moveDefHandler.GetNumMoveDefs())
+			md = moveDefHandler.GetMoveDefByPathType(i);
+
+		if (md == nullptr) {
+			LOG_L(L_WARNING, "/%s: unknown MoveDef %s", GetCommand().c_str(), args[0].c_str());
+			return true;
+		}
+
+		const int numSearches = (args.size() > 1)? StringToInt(args[1]): 100;
+		const int seed = (args.size() > 2)? StringToInt(args[2]): 0;
+
+		pm->RunSearchBenchmark(md->pathType, std::max(1, numSearches), seed);
+		return true;
+	}
+};
+
 
 
 class ShareDialogActionExecutor : public IUnsyncedActionExecutor {
@@ -4046,6 +4093,7 @@ void UnsyncedGameCommands::AddDefaultActionExecutors()
 	AddActionExecutor(AllocActionExecutor<ToggleLOSActionExecutor>());
 	AddActionExecutor(AllocActionExecutor<ToggleInfoActionExecutor>());
 	AddActionExecutor(AllocActionExecutor<ShowPathTypeActionExecutor>());
+	AddActionExecutor(AllocActionExecutor<PathSearchBenchActionExecutor>());
 	AddActionExecutor(AllocActionExecutor<ShareDialogActionExecutor>());
 	AddActionExecutor(AllocActionExecutor<QuitMessageActionExecutor>());
 	AddActionExecutor(AllocActionExecutor<QuitMenuActionExecutor>());
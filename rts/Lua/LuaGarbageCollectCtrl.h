@@ -3,6 +3,7 @@
 #ifndef SPRING_LUA_GARBAGE_COLLECT_CTRL_H
 #define SPRING_LUA_GARBAGE_COLLECT_CTRL_H
 
+#include <cstdint>
 #include <limits>
 
 struct SLuaGarbageCollectCtrl {
@@ -20,6 +21,14 @@ struct SLuaGarbageCollectCtrl {
 
 	float baseRunTimeMult = 0.0f;
 	float baseMemLoadMult = 0.0f;
+
+	// share of the global per-frame GC budget assigned to this state by
+	// CLuaHandle::SetGarbageCollectBudget, in milliseconds; negative if
+	// the global budget is disabled (then the bounds above apply alone)
+	float frameBudgetShare = -1.0f;
+
+	// allocation count at the time the last budget share was assigned
+	uint64_t prevNumLuaAllocs = 0;
 };
 
 #endif
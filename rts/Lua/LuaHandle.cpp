@@ -43,6 +43,7 @@
 #include "System/Rectangle.h"
 #include "System/ScopedFPUSettings.h"
 #include "System/StringUtil.h"
+#include "System/TimeProfiler.h"
 #include "System/Log/ILog.h"
 #include "System/Input/KeyInput.h"
 #include "System/Platform/SDL1_keysym.h"
@@ -147,6 +148,10 @@ CLuaHandle::CLuaHandle(const string& _name, int _order, bool _userMode, bool _sy
 	D.gcCtrl.baseMemLoadMult = configHandler->GetFloat("LuaGarbageCollectionMemLoadMult");
 	D.gcCtrl.baseRunTimeMult = configHandler->GetFloat("LuaGarbageCollectionRunTimeMult");
 
+	// per-handle GC timer, shown in the profiler next to the aggregate ones
+	gcTimerName = "Lua::CollectGarbage::" + name + ((_synced)? "::Synced": "::Unsynced");
+	CTimeProfiler::RegisterTimer(gcTimerName.c_str());
+
 	L = LUA_OPEN(&D);
 	L_GC = lua_newthread(L);
 
@@ -205,6 +210,8 @@ void CLuaHandle::KillLua(bool inFreeHandler)
 	// false and FreeHandler runs next
 	LUA_ERASE_CONTEXT(&D, LUAHANDLE_CONTEXTS[D.synced]);
 	LUA_CLOSE(&L);
+
+	CTimeProfiler::UnRegisterTimer(gcTimerName.c_str());
 }
 
 
@@ -3887,8 +3894,11 @@ void CLuaHandle::CollectGarbage(bool forced)
 	RECOIL_DETAILED_TRACY_ZONE;
 	const float gcMemLoadMult = D.gcCtrl.baseMemLoadMult;
 	const float gcRunTimeMult = D.gcCtrl.baseRunTimeMult;
+	const float gcBudgetShare = D.gcCtrl.frameBudgetShare;
 
-	if (!forced && spring_lua_alloc_skip_gc(gcMemLoadMult))
+	// a budgeted state runs exactly as long as its share allows, the
+	// random memory-load based skipping only applies without a budget
+	if (!forced && ((gcBudgetShare < 0.0f)? spring_lua_alloc_skip_gc(gcMemLoadMult): (gcBudgetShare == 0.0f)))
 		return;
 
 	LUA_CALL_IN_CHECK_NAMED(L, (GetLuaContextData(L)->synced)? "Lua::CollectGarbage::Synced": "Lua::CollectGarbage::Unsynced");
@@ -3908,7 +3918,10 @@ void CLuaHandle::CollectGarbage(bool forced)
 	// mean too much time is spent on it, must weigh the per-call period
 	const float gcSpeedFactor = std::clamp(gs->speedFactor * (1 - gs->PreSimFrame()) * (1 - gs->paused), 1.0f, 50.0f);
 	const float gcBaseRunTime = smoothstep(10.0f, 100.0f, gcMemFootPrint / 1024);
-	const float gcLoopRunTime = std::clamp((gcBaseRunTime * gcRunTimeMult) / gcSpeedFactor, D.gcCtrl.minLoopRunTime, D.gcCtrl.maxLoopRunTime);
+	const float gcHintRunTime = (gcBudgetShare < 0.0f)? ((gcBaseRunTime * gcRunTimeMult) / gcSpeedFactor): gcBudgetShare;
+	// a budget share has no lower bound, the shares must not add up to more than the budget
+	const float gcMinRunTime = (gcBudgetShare < 0.0f)? D.gcCtrl.minLoopRunTime: 0.0f;
+	const float gcLoopRunTime = std::clamp(gcHintRunTime, gcMinRunTime, D.gcCtrl.maxLoopRunTime);
 
 	const spring_time startTime = spring_gettime();
 	const spring_time   endTime = startTime + spring_msecs(gcLoopRunTime);
@@ -3948,9 +3961,47 @@ void CLuaHandle::CollectGarbage(bool forced)
 		gcStepsPerIter  = std::clamp(gcStepsPerIter, D.gcCtrl.minStepsPerIter, D.gcCtrl.maxStepsPerIter);
 	}
 
+	CTimeProfiler::GetInstance().AddTime(hashString(gcTimerName), startTime, finishTime - startTime);
 	eventHandler.DbgTimingInfo(TIMING_GC, startTime, finishTime);
 }
 
+
+void CLuaHandle::SetGarbageCollectBudget(float frameBudget)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	// [0] := unsynced, [1] := synced
+	// gcCtrl is not part of a context's identity, safe to modify in-place
+	const auto GetGCCtrl = [](const luaContextData* lcd) { return &(const_cast<luaContextData*>(lcd)->gcCtrl); };
+	const auto GetNumAllocs = [](const luaContextData* lcd) -> uint64_t {
+		const uint64_t curNumAllocs = lcd->allocState.numLuaAllocs.load();
+		const uint64_t prvNumAllocs = lcd->gcCtrl.prevNumLuaAllocs;
+		// +1 so that idle states are not starved and still finish their cycles
+		return ((curNumAllocs - std::min(prvNumAllocs, curNumAllocs)) + 1);
+	};
+
+	uint64_t sumNumAllocs = 0;
+
+	for (bool synced: {false, true}) {
+		for (const luaContextData* lcd: *LUAHANDLE_CONTEXTS[synced]) {
+			sumNumAllocs += GetNumAllocs(lcd);
+		}
+	}
+
+	for (bool synced: {false, true}) {
+		for (const luaContextData* lcd: *LUAHANDLE_CONTEXTS[synced]) {
+			SLuaGarbageCollectCtrl* gcCtrl = GetGCCtrl(lcd);
+
+			if (frameBudget <= 0.0f) {
+				gcCtrl->frameBudgetShare = -1.0f;
+			} else {
+				gcCtrl->frameBudgetShare = frameBudget * (GetNumAllocs(lcd) / float(sumNumAllocs));
+			}
+
+			gcCtrl->prevNumLuaAllocs = lcd->allocState.numLuaAllocs.load();
+		}
+	}
+}
+
 /******************************************************************************/
 /******************************************************************************/
 
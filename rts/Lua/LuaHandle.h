@@ -338,6 +338,7 @@ class CLuaHandle : public CEventClient
 		luaContextData D;
 
 		std::string killMsg;
+		std::string gcTimerName;
 
 		std::map <int, std::vector <std::pair <int, std::vector <int>>>> delayedCallsByFrame;
 		void RunDelayedFunctions(int frameNum);
@@ -382,6 +383,10 @@ class CLuaHandle : public CEventClient
 
 		static void HandleLuaMsg(int playerID, int script, int mode, const std::vector<std::uint8_t>& msg);
 
+		// shares <frameBudget> milliseconds of GC time out over all states
+		// proportional to their allocation rates; <= 0 disables the budget
+		static void SetGarbageCollectBudget(float frameBudget);
+
 	protected: // static
 		static bool devMode; // allows real file access
 
@@ -64,10 +64,15 @@ void LuaMemPool::ReleasePtr(LuaMemPool* p, const CLuaHandle* o)
 	gCount -= (o != nullptr);
 
 	if (p == GetSharedPtr()) {
-		p->GetSharedCount() -= 1;
+		if ((p->GetSharedCount() -= 1) == 0)
+			p->Clear();
+
 		return;
 	}
 
+	// the owning state has been closed, hand all its blocks back at once
+	p->Clear();
+
 	gMutex.lock();
 	gIndcs.push_back(p->GetGlobalIndex());
 	gMutex.unlock();
@@ -104,11 +109,33 @@ void LuaMemPool::Clear()
 {
 	RECOIL_DETAILED_TRACY_ZONE;
 	//allocStats = {};
+
+	if (!LuaMemPool::enabled || !dirty)
+		return;
+
+	// a pool can only be reset wholesale once every block has been returned
+	// (i.e. after lua_close); recreating the backing allocator then releases
+	// all bucket memory in one go so that a reloaded state does not inherit
+	// the fragmentation left behind by its predecessor
+	if (liveAllocs != 0)
+		return;
+
+	luaMemPoolImpl = nullptr;
+	luaMemPoolImpl = std::make_unique<LuaMemPool::LuaMemPoolImpl>();
+
+	liveBytes = 0;
+	numResets += 1;
+	dirty = false;
 }
 
 void* LuaMemPool::Alloc(size_t size)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
+	liveAllocs += 1;
+	liveBytes += size;
+	peakBytes = std::max(peakBytes, liveBytes);
+	dirty = true;
+
 	if (!LuaMemPool::enabled) {
 		allocStats[STAT_NAE] += 1 * (size > 0);
 		allocStats[STAT_NBE] += size;
@@ -144,6 +171,10 @@ void* LuaMemPool::Realloc(void* ptr, size_t nsize, size_t osize)
 	if (ptr == nullptr || osize == 0)
 		return Alloc(nsize);
 
+	liveBytes -= osize;
+	liveBytes += nsize;
+	peakBytes = std::max(peakBytes, liveBytes);
+
 	if (!LuaMemPool::enabled) {
 		void* newPtr = ::operator new(nsize);
 
@@ -185,6 +216,12 @@ void* LuaMemPool::Realloc(void* ptr, size_t nsize, size_t osize)
 void LuaMemPool::Free(void* ptr, size_t size)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
+	if (ptr == nullptr)
+		return;
+
+	liveAllocs -= 1;
+	liveBytes -= size;
+
 	if (!LuaMemPool::enabled) {
 		::operator delete(ptr);
 		return;
@@ -202,7 +239,7 @@ void LuaMemPool::LogStats(const char* handle, const char* lctype)
 	const float avgAllocTimeF = static_cast<float>(allocStats[STAT_NTF]) / static_cast<float>(std::max(allocStats[STAT_NAF], one));
 	const float avgAllocTimeE = static_cast<float>(allocStats[STAT_NTE]) / static_cast<float>(std::max(allocStats[STAT_NAE], one));
 	std::string msg = fmt::sprintf(
-		"[LuaMemPool::%s][handle=%s (%s)] index=%u numAllocs{int+, int-, ext, int_p}={%u, %u, %u, %.1f} allocedSize{int+, int-, ext}={%u, %u, %u}, avgAllocTime{int+, int-, ext}={%.4f, %.4f, %.4f}, cumAllocTime={int+, int-, ext}={%u, %u, %u}",
+		"[LuaMemPool::%s][handle=%s (%s)] index=%u numAllocs{int+, int-, ext, int_p}={%u, %u, %u, %.1f} allocedSize{int+, int-, ext}={%u, %u, %u}, avgAllocTime{int+, int-, ext}={%.4f, %.4f, %.4f}, cumAllocTime={int+, int-, ext}={%u, %u, %u}, live{allocs, bytes, peakBytes}={%u, %u, %u}, numResets=%u",
 		__func__,
 		handle,
 		lctype,
@@ -219,7 +256,11 @@ void LuaMemPool::LogStats(const char* handle, const char* lctype)
 		avgAllocTimeE,
 		allocStats[STAT_NTI],
 		allocStats[STAT_NTF],
-		allocStats[STAT_NTE]
+		allocStats[STAT_NTE],
+		liveAllocs,
+		liveBytes,
+		peakBytes,
+		numResets
 	);
 	LOG("%s", msg.c_str());
 	allocStats = {};
@@ -18,8 +18,6 @@ public:
 	explicit LuaMemPool(size_t lmpIndex);
 
 	~LuaMemPool() {
-		Clear();
-
 		if (!LuaMemPool::enabled)
 			return;
 
@@ -51,6 +49,9 @@ public:
 
 	void LogStats(const char* handle, const char* lctype);
 
+	size_t  GetLiveAllocs() const { return liveAllocs; }
+	size_t  GetLiveBytes() const { return liveBytes; }
+
 	size_t  GetGlobalIndex() const { return globalIndex; }
 	size_t  GetSharedCount() const { return sharedCount; }
 	size_t& GetSharedCount()       { return sharedCount; }
@@ -77,6 +78,15 @@ private:
 
 	std::array<uint64_t, 9> allocStats = { 0, 0, 0, 0, 0 };
 
+	// not reset by LogStats; these describe the pool's current contents
+	size_t liveAllocs = 0;
+	size_t liveBytes = 0;
+	size_t peakBytes = 0;
+	size_t numResets = 0;
+
+	// true if any block was handed out since the last (bulk) reset
+	bool dirty = false;
+
 	size_t globalIndex = 0;
 	size_t sharedCount = 0;
 };
\ No newline at end of file
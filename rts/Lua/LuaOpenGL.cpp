@@ -4830,7 +4830,7 @@ int LuaOpenGL::BindImageTexture(lua_State* L)
  * @function gl.CreateTextureAtlas
  * @param xsize integer
  * @param ysize integer
- * @param allocType integer?
+ * @param allocType integer? 0 legacy (default), 1 quadtree, 2 row, 3 skyline
  * @return string texName
  */
 //TODO DRY pass
@@ -4848,7 +4848,7 @@ int LuaOpenGL::CreateTextureAtlas(lua_State* L)
 	if (xsize > maxSizeX || ysize > maxSizeY)
 		luaL_error(L, "gl.%s() The specified atlas dimensions (%d, %d) are too large. The maximum side sizes are (%d, %d)", __func__, xsize, ysize, maxSizeX, maxSizeY);
 
-	const int allocType = std::clamp(luaL_optint(L, 3, 0), (int)CTextureAtlas::ATLAS_ALLOC_LEGACY, (int)CTextureAtlas::ATLAS_ALLOC_ROW);
+	const int allocType = std::clamp(luaL_optint(L, 3, 0), (int)CTextureAtlas::ATLAS_ALLOC_LEGACY, (int)CTextureAtlas::ATLAS_ALLOC_SKYLINE);
 
 	LuaAtlasTextures& atlasTexes = CLuaHandle::GetActiveAtlasTextures(L);
 	const string& texName = atlasTexes.Create(xsize, ysize, allocType);
@@ -3536,9 +3536,11 @@ int LuaSyncedCtrl::SetUnitPieceParent(lua_State* L)
 		return 0;
 	}
 
-	childPiece->parent->RemoveChild(childPiece);
-	childPiece->SetParent(parentPiece);
-	parentPiece->AddChild(childPiece);
+	if (!unit->localModel.SetPieceParent(childPiece, parentPiece)) {
+		luaL_error(L, "Can't attach a piece to one of its own children");
+		return 0;
+	}
+
 	return 0;
 }
 
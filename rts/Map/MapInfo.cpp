@@ -468,6 +468,9 @@ void CMapInfo::ReadPFSConstants()
 
 	qtpfsConsts.layersPerUpdate = qtpfsTable.GetInt("layersPerUpdate",  5);
 	qtpfsConsts.maxTeamSearches = qtpfsTable.GetInt("maxTeamSearches", 25);
+	qtpfsConsts.maxSearchesPerFrame = std::max(0, qtpfsTable.GetInt("maxSearchesPerFrame", 0));
+	qtpfsConsts.minGoalFieldSearches = std::max(0, qtpfsTable.GetInt("minGoalFieldSearches", 0));
+	qtpfsConsts.maxGoalFields = std::max(1, qtpfsTable.GetInt("maxGoalFields", 8));
 	qtpfsConsts.minNodeSizeX    = qtpfsTable.GetInt("minNodeSizeX",     8);
 	qtpfsConsts.minNodeSizeZ    = qtpfsTable.GetInt("minNodeSizeZ",     8);
 	qtpfsConsts.maxNodeDepth    = qtpfsTable.GetInt("maxNodeDepth",    16);
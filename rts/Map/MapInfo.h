@@ -213,6 +213,9 @@ public:
 		struct qtpfs_constants_t {
 			unsigned int layersPerUpdate;
 			unsigned int maxTeamSearches;
+			unsigned int maxSearchesPerFrame;
+			unsigned int minGoalFieldSearches;
+			unsigned int maxGoalFields;
 			unsigned int minNodeSizeX;
 			unsigned int minNodeSizeZ;
 			unsigned int maxNodeDepth;
@@ -78,12 +78,15 @@ CSMFGroundTextures::CSMFGroundTextures(CSMFReadMap* rm): smfMap(rm)
 	smfTextureLodBias = configHandler->GetFloat("SMFTextureLodBias");
 
 	LoadTiles(smfMap->GetMapFile());
+
+#ifndef HEADLESS
 	if (smfTextureStreaming) {
 		LoadSquareTextures(3);
 		ConvolveHeightMap(mapDims.mapx, 1);
 	} else {
 		LoadSquareTexturesPersistent();
 	}
+#endif
 }
 
 void CSMFGroundTextures::LoadTiles(CSMFMapFile& file)
@@ -127,6 +130,17 @@ void CSMFGroundTextures::LoadTiles(CSMFMapFile& file)
 		}
 	}
 
+	struct TileFile {
+		std::string path;
+		std::string name;
+
+		int firstTile;
+		int numTiles;
+	};
+
+	std::vector<TileFile> tileFiles;
+	tileFiles.reserve(tileHeader.numTileFiles);
+
 	for (int a = 0, curTile = 0; a < tileHeader.numTileFiles; ++a) {
 		int numSmallTiles = 0;
 		char fileNameBuffer[256] = {0};
@@ -135,45 +149,65 @@ void CSMFGroundTextures::LoadTiles(CSMFMapFile& file)
 		ifs->ReadString(&fileNameBuffer[0], sizeof(char) * (sizeof(fileNameBuffer) - 1));
 		swabDWordInPlace(numSmallTiles);
 
-		std::string smtFileName = fileNameBuffer;
-		std::string smtFilePath = (!smtHeaderOverride)?
-			(smfDir + smtFileName):
-			(smfDir + smf.smtFileNames[a]);
+		if (numSmallTiles < 0 || (curTile + numSmallTiles) > tileHeader.numTiles) {
+			std::string err = fmt::sprintf("[SMFGroundTextures::%s] tile-file %d holds %d tiles, exceeding header.numTiles=%d", __func__, a, numSmallTiles, tileHeader.numTiles);
+			throw content_error(err);
+		}
+
+		std::string smtFileName = (!smtHeaderOverride)? std::string(fileNameBuffer): smf.smtFileNames[a];
+		std::string smtFilePath = smfDir + smtFileName;
+
+		tileFiles.push_back({std::move(smtFilePath), std::move(smtFileName), curTile, numSmallTiles});
+		curTile += numSmallTiles;
+	}
+
+	ifs->Read(&tileMap[0], smfMap->tileCount * sizeof(int));
+
+	// headless has nothing to upload the tiles to, leave them zeroed
+#ifndef HEADLESS
+	std::vector<std::string> tileFileErrors(tileFiles.size());
+
+	// tile-files are independent and fill disjoint ranges of <tiles>
+	for_mt(0, tileFiles.size(), [&](const int a) {
+		const TileFile& tf = tileFiles[a];
 
+		std::string smtFilePath = tf.path;
 		CFileHandler tileFile(smtFilePath);
 
 		// try absolute path
 		if (!tileFile.FileExists())
-			tileFile.Open(smtFilePath = (!smtHeaderOverride) ? smtFileName : smf.smtFileNames[a]);
+			tileFile.Open(smtFilePath = tf.name);
 
 		if (!tileFile.FileExists()) {
 			LOG_L(L_WARNING,
 				"[SMFGroundTextures::%s] could not find .smt tile-file %d (\"%s\"; ALL %d SMALL TILES WILL BE MADE RED)",
-				__func__, a, smtFilePath.c_str(), numSmallTiles
+				__func__, a, smtFilePath.c_str(), tf.numTiles
 			);
 
-			memset(&tiles[curTile * SMALL_TILE_SIZE], 0xaa, numSmallTiles * SMALL_TILE_SIZE);
-			curTile += numSmallTiles;
-			continue;
+			memset(&tiles[tf.firstTile * SMALL_TILE_SIZE], 0xaa, tf.numTiles * SMALL_TILE_SIZE);
+			return;
 		}
 
 		TileFileHeader tfh;
 		CSMFMapFile::ReadMapTileFileHeader(tfh, tileFile);
 
 		if (strcmp(tfh.magic, "spring tilefile") != 0 || tfh.version != 1 || tfh.tileSize != 32 || tfh.compressionType != 1) {
-			std::string err = fmt::sprintf(
+			tileFileErrors[a] = fmt::sprintf(
 				"[SMFGroundTextures::%s] tile-file %d (path=\"%s\" magic=\"%s\" version=%d tileSize=%d comprType=%d) does not match .smt format",
 				__func__, a, smtFilePath.c_str(), tfh.magic, tfh.version, tfh.tileSize, tfh.compressionType
 			);
-			throw content_error(err);
+			return;
 		}
 
-		for (int b = 0; b < numSmallTiles; ++b) {
-			tileFile.Read(&tiles[(curTile++) * SMALL_TILE_SIZE], SMALL_TILE_SIZE);
-		}
-	}
+		// tiles are stored back to back, read them in one go
+		tileFile.Read(&tiles[tf.firstTile * SMALL_TILE_SIZE], tf.numTiles * SMALL_TILE_SIZE);
+	});
 
-	ifs->Read(&tileMap[0], smfMap->tileCount * sizeof(int));
+	for (const std::string& err: tileFileErrors) {
+		if (!err.empty())
+			throw content_error(err);
+	}
+#endif
 
 	for (int i = 0; i < smfMap->tileCount; i++) {
 		swabDWordInPlace(tileMap[i]);
@@ -210,14 +244,43 @@ void CSMFGroundTextures::LoadSquareTexturesPersistent()
 	RECOIL_DETAILED_TRACY_ZONE;
 	loadscreen->SetLoadMessage("Loading Square Textures");
 
+	const size_t numSquareInts = GetSquareMipChainSize() / sizeof(GLint);
+
+	// extract a row of squares on the thread-pool at a time, the
+	// uploads themselves have to stay on the thread owning the GL
+	// context
+	std::vector<GLint> tilesBuffer(smfMap->numBigTexX * numSquareInts);
+
 	for (int y = 0; y < smfMap->numBigTexY; ++y) {
+		for_mt(0, smfMap->numBigTexX, [&](const int x) {
+			ExtractSquareMipChain(x, y, &tilesBuffer[x * numSquareInts]);
+		});
+
 		for (int x = 0; x < smfMap->numBigTexX; ++x) {
-			// start at the lowest mip-level
-			LoadSquareTexturePersistent(x, y);
+			LoadSquareTexturePersistent(x, y, &tilesBuffer[x * numSquareInts]);
 		}
 	}
 }
 
+void CSMFGroundTextures::ExtractSquareMipChain(int x, int y, GLint* tileBuf) const
+{
+	for (int level = 0; level <= 3; ++level) {
+		ExtractSquareTiles(x, y, level, tileBuf);
+		tileBuf += (((smfMap->bigTexSize >> level) * (smfMap->bigTexSize >> level)) / 2 / sizeof(GLint));
+	}
+}
+
+size_t CSMFGroundTextures::GetSquareMipChainSize() const
+{
+	size_t numBytes = 0;
+
+	for (int level = 0; level <= 3; ++level) {
+		numBytes += (((smfMap->bigTexSize >> level) * (smfMap->bigTexSize >> level)) / 2);
+	}
+
+	return numBytes;
+}
+
 void CSMFGroundTextures::ConvolveHeightMap(const int mapWidth, const int mipLevel)
 {
 	SCOPED_ONCE_TIMER("CSMFGroundTextures::ConvolveHeightMap");
@@ -586,6 +649,14 @@ void CSMFGroundTextures::LoadSquareTexture(int x, int y, int level)
 }
 
 void CSMFGroundTextures::LoadSquareTexturePersistent(int x, int y)
+{
+	std::vector<GLint> tilesBuffer(GetSquareMipChainSize() / sizeof(GLint));
+
+	ExtractSquareMipChain(x, y, tilesBuffer.data());
+	LoadSquareTexturePersistent(x, y, tilesBuffer.data());
+}
+
+void CSMFGroundTextures::LoadSquareTexturePersistent(int x, int y, const GLint* tilesBuffer)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
 	static constexpr GLenum ttarget = GL_TEXTURE_2D;
@@ -614,12 +685,12 @@ void CSMFGroundTextures::LoadSquareTexturePersistent(int x, int y)
 	if (smfMap->GetTexAnisotropyLevel(false) != 0.0f)
 		glTexParameterf(ttarget, GL_TEXTURE_MAX_ANISOTROPY_EXT, smfMap->GetTexAnisotropyLevel(false));
 
-	std::vector<GLint> tilesBuffer(smfMap->bigTexSize * smfMap->bigTexSize / 2 / sizeof(GLint));
+	// <tilesBuffer> holds the extracted tiles of all four levels back to back
 	for (int level = 0; level <= 3; ++level) {
 		const int mipSqSize = smfMap->bigTexSize >> level;
 		const int numSqBytes = (mipSqSize * mipSqSize) / 2;
-		ExtractSquareTiles(x, y, level, tilesBuffer.data());
-		glCompressedTexImage2D(ttarget, level, tileTexFormat, mipSqSize, mipSqSize, 0, numSqBytes, tilesBuffer.data());
+		glCompressedTexImage2D(ttarget, level, tileTexFormat, mipSqSize, mipSqSize, 0, numSqBytes, tilesBuffer);
+		tilesBuffer += (numSqBytes / sizeof(GLint));
 	}
 
 	glBindTexture(ttarget, 0);
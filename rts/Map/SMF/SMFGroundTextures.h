@@ -28,8 +28,11 @@ protected:
 	void ConvolveHeightMap(const int mapWidth, const int mipLevel);
 	bool RecompressTilesIfNeeded();
 	void ExtractSquareTiles(const int texSquareX, const int texSquareY, const int mipLevel, GLint* tileBuf) const;
+	void ExtractSquareMipChain(int x, int y, GLint* tileBuf) const;
 	void LoadSquareTexture(int x, int y, int level);
 	void LoadSquareTexturePersistent(int x, int y);
+	void LoadSquareTexturePersistent(int x, int y, const GLint* tilesBuffer);
+	size_t GetSquareMipChainSize() const;
 
 	inline bool TexSquareInView(int, int) const;
 
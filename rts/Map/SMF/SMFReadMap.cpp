@@ -54,6 +54,21 @@ std::vector<float> CSMFReadMap::cornerHeightMapUnsynced;
 
 static std::vector<float> normalPixels;
 
+enum {
+	SMF_BITMAP_MINIMAP,
+	SMF_BITMAP_SPECULAR,
+	SMF_BITMAP_SKY_REFLECT_MOD,
+	SMF_BITMAP_BLEND_NORMALS,
+	SMF_BITMAP_LIGHT_EMISSION,
+	SMF_BITMAP_PARALLAX_HEIGHT,
+	SMF_BITMAP_SPLAT_DETAIL,
+	SMF_BITMAP_SPLAT_DISTR,
+	SMF_BITMAP_GRASS_SHADING,
+	SMF_BITMAP_DETAIL,
+	SMF_BITMAP_SPLAT_DETAIL_NORMAL,
+	SMF_BITMAP_COUNT = SMF_BITMAP_SPLAT_DETAIL_NORMAL + CSMFReadMap::NUM_SPLAT_DETAIL_NORMALS,
+};
+
 CSMFReadMap::CSMFReadMap(const std::string& mapName): CEventClient("[CSMFReadMap]", 271950, false)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
@@ -82,25 +97,38 @@ CSMFReadMap::CSMFReadMap(const std::string& mapName): CEventClient("[CSMFReadMap
 	haveSplatNormalDistribTexture &= !mapInfo->smf.splatDistrTexName.empty();
 
 	ParseHeader();
-	LoadHeightMap();
-	CReadMap::Initialize();
-
-	ConfigureTexAnisotropyLevels();
-	{
-		auto lock = CLoadLock::GetUniqueLock();
+	// decode the map's images in the background, only creating
+	// the textures from them has to happen on this thread
+	LoadMapBitmaps();
 
-		LoadMinimap();
+	try {
+		LoadHeightMap();
+		CReadMap::Initialize();
 
-		CreateSpecularTex();
-		CreateSplatDetailTextures();
-		CreateGrassTex();
-		CreateDetailTex();
-		CreateShadingTex();
-		CreateNormalTex();
-		CreateHeightMapTex();
-		CreateShadingGL();
+		ConfigureTexAnisotropyLevels();
+		{
+			auto lock = CLoadLock::GetUniqueLock();
+
+			LoadMinimap();
+
+			CreateSpecularTex();
+			CreateSplatDetailTextures();
+			CreateGrassTex();
+			CreateDetailTex();
+			CreateShadingTex();
+			CreateNormalTex();
+			CreateHeightMapTex();
+			CreateShadingGL();
+		}
+	} catch (...) {
+		// the pending loads write into mapBitmaps, which dies with us
+		WaitMapBitmaps();
+		throw;
 	}
 
+	mapBitmaps.clear();
+	mapBitmapLoads.clear();
+
 	mapFile.ReadFeatureInfo();
 }
 
@@ -133,6 +161,86 @@ void CSMFReadMap::ParseHeader()
 }
 
 
+void CSMFReadMap::LoadMapBitmaps()
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	const CMapInfo::smf_t& smf = mapInfo->smf;
+
+	std::array<const std::string*, SMF_BITMAP_COUNT> texNames = {};
+
+	// only the images that the Create* functions below will ask for
+	texNames[SMF_BITMAP_MINIMAP      ] = &smf.minimapTexName;
+	texNames[SMF_BITMAP_GRASS_SHADING] = &smf.grassShadingTexName;
+	texNames[SMF_BITMAP_DETAIL       ] = &smf.detailTexName;
+
+	if (haveSpecularTexture) {
+		texNames[SMF_BITMAP_SPECULAR       ] = &smf.specularTexName;
+		texNames[SMF_BITMAP_SKY_REFLECT_MOD] = &smf.skyReflectModTexName;
+		texNames[SMF_BITMAP_BLEND_NORMALS  ] = &smf.blendNormalsTexName;
+		texNames[SMF_BITMAP_LIGHT_EMISSION ] = &smf.lightEmissionTexName;
+		texNames[SMF_BITMAP_PARALLAX_HEIGHT] = &smf.parallaxHeightTexName;
+	}
+
+	if (haveSplatDetailDistribTexture) {
+		texNames[SMF_BITMAP_SPLAT_DETAIL] = &smf.splatDetailTexName;
+		texNames[SMF_BITMAP_SPLAT_DISTR ] = &smf.splatDistrTexName;
+
+		for (size_t i = 0; i < smf.splatDetailNormalTexNames.size() && haveSplatNormalDistribTexture; i++) {
+			if (i == NUM_SPLAT_DETAIL_NORMALS)
+				break;
+
+			texNames[SMF_BITMAP_SPLAT_DETAIL_NORMAL + i] = &smf.splatDetailNormalTexNames[i];
+		}
+	}
+
+	mapBitmaps.clear();
+	mapBitmaps.resize(SMF_BITMAP_COUNT);
+	mapBitmapLoads.clear();
+	mapBitmapLoads.resize(SMF_BITMAP_COUNT);
+
+	for (int i = 0; i < SMF_BITMAP_COUNT; i++) {
+		if (texNames[i] == nullptr || texNames[i]->empty())
+			continue;
+
+	#ifdef HEADLESS
+		// headless never creates real textures, skip decoding entirely
+		std::promise<bool> dummyLoad;
+		dummyLoad.set_value(true);
+		mapBitmapLoads[i] = dummyLoad.get_future().share();
+	#else
+		mapBitmapLoads[i] = ThreadPool::Enqueue([this, i, texName = *texNames[i]]() {
+			return mapBitmaps[i].Load(texName);
+		});
+	#endif
+	}
+}
+
+void CSMFReadMap::WaitMapBitmaps()
+{
+	for (const std::shared_future<bool>& load: mapBitmapLoads) {
+		if (load.valid())
+			load.wait();
+	}
+}
+
+bool CSMFReadMap::TakeMapBitmap(int bitmapIdx, CBitmap& bitmap)
+{
+	// nothing was requested for this image (empty name)
+	if (!mapBitmapLoads[bitmapIdx].valid())
+		return false;
+
+#ifdef HEADLESS
+	bitmap.AllocDummy();
+	return true;
+#else
+	const bool loaded = mapBitmapLoads[bitmapIdx].get();
+
+	bitmap = std::move(mapBitmaps[bitmapIdx]);
+	return loaded;
+#endif
+}
+
+
 void CSMFReadMap::LoadHeightMap()
 {
 	RECOIL_DETAILED_TRACY_ZONE;
@@ -166,7 +274,7 @@ void CSMFReadMap::LoadMinimap()
 	RECOIL_DETAILED_TRACY_ZONE;
 	CBitmap minimapTexBM;
 
-	if (minimapTexBM.Load(mapInfo->smf.minimapTexName)) {
+	if (TakeMapBitmap(SMF_BITMAP_MINIMAP, minimapTexBM)) {
 		minimapTex.SetRawTexID(minimapTexBM.CreateTexture());
 		minimapTex.SetRawSize(int2(minimapTexBM.xsize, minimapTexBM.ysize));
 		return;
@@ -202,7 +310,7 @@ void CSMFReadMap::CreateSpecularTex()
 		CBitmap specularTexBM;
 
 		// maps wants specular lighting, but no moderation
-		if (!specularTexBM.Load(mapInfo->smf.specularTexName)) {
+		if (!TakeMapBitmap(SMF_BITMAP_SPECULAR, specularTexBM)) {
 			LOG_L(L_WARNING, "[CSMFReadMap::%s] Invalid SMF specularTex %s. Creating fallback texture", __func__, mapInfo->smf.specularTexName.c_str());
 			specularTexBM.AllocDummy(SColor(255, 255, 255, 255));
 		}
@@ -215,7 +323,7 @@ void CSMFReadMap::CreateSpecularTex()
 		CBitmap skyReflectModTexBM;
 
 		// no default 1x1 textures for these
-		if (skyReflectModTexBM.Load(mapInfo->smf.skyReflectModTexName)) {
+		if (TakeMapBitmap(SMF_BITMAP_SKY_REFLECT_MOD, skyReflectModTexBM)) {
 			skyReflectModTex.SetRawTexID(skyReflectModTexBM.CreateTexture());
 			skyReflectModTex.SetRawSize(int2(skyReflectModTexBM.xsize, skyReflectModTexBM.ysize));
 		}
@@ -224,7 +332,7 @@ void CSMFReadMap::CreateSpecularTex()
 	{
 		CBitmap blendNormalsTexBM;
 
-		if (blendNormalsTexBM.Load(mapInfo->smf.blendNormalsTexName)) {
+		if (TakeMapBitmap(SMF_BITMAP_BLEND_NORMALS, blendNormalsTexBM)) {
 			blendNormalsTex.SetRawTexID(blendNormalsTexBM.CreateTexture());
 			blendNormalsTex.SetRawSize(int2(blendNormalsTexBM.xsize, blendNormalsTexBM.ysize));
 		}
@@ -233,7 +341,7 @@ void CSMFReadMap::CreateSpecularTex()
 	{
 		CBitmap lightEmissionTexBM;
 
-		if (lightEmissionTexBM.Load(mapInfo->smf.lightEmissionTexName)) {
+		if (TakeMapBitmap(SMF_BITMAP_LIGHT_EMISSION, lightEmissionTexBM)) {
 			lightEmissionTex.SetRawTexID(lightEmissionTexBM.CreateTexture());
 			lightEmissionTex.SetRawSize(int2(lightEmissionTexBM.xsize, lightEmissionTexBM.ysize));
 		}
@@ -242,7 +350,7 @@ void CSMFReadMap::CreateSpecularTex()
 	{
 		CBitmap parallaxHeightTexBM;
 
-		if (parallaxHeightTexBM.Load(mapInfo->smf.parallaxHeightTexName)) {
+		if (TakeMapBitmap(SMF_BITMAP_PARALLAX_HEIGHT, parallaxHeightTexBM)) {
 			parallaxHeightTex.SetRawTexID(parallaxHeightTexBM.CreateTexture());
 			parallaxHeightTex.SetRawSize(int2(parallaxHeightTexBM.xsize, parallaxHeightTexBM.ysize));
 		}
@@ -261,7 +369,7 @@ void CSMFReadMap::CreateSplatDetailTextures()
 		// if a map supplies an intensity- AND a distribution-texture for
 		// detail-splat blending, the regular detail-texture is not used
 		// default detail-texture should be all-grey
-		if (!splatDetailTexBM.Load(mapInfo->smf.splatDetailTexName)) {
+		if (!TakeMapBitmap(SMF_BITMAP_SPLAT_DETAIL, splatDetailTexBM)) {
 			LOG_L(L_WARNING, "[CSMFReadMap::%s] Invalid SMF splatDetailTex %s. Creating fallback texture", __func__, mapInfo->smf.splatDetailTexName.c_str());
 			splatDetailTexBM.AllocDummy(SColor(127, 127, 127, 127));
 		}
@@ -273,7 +381,7 @@ void CSMFReadMap::CreateSplatDetailTextures()
 	{
 		CBitmap splatDistrTexBM;
 
-		if (!splatDistrTexBM.Load(mapInfo->smf.splatDistrTexName)) {
+		if (!TakeMapBitmap(SMF_BITMAP_SPLAT_DISTR, splatDistrTexBM)) {
 			LOG_L(L_WARNING, "[CSMFReadMap::%s] Invalid SMF splatDistrTex %s. Creating fallback texture", __func__, mapInfo->smf.splatDistrTexName.c_str());
 			splatDistrTexBM.AllocDummy(SColor(255, 0, 0, 0));
 		}
@@ -292,7 +400,7 @@ void CSMFReadMap::CreateSplatDetailTextures()
 
 		CBitmap splatDetailNormalTextureBM;
 
-		if (!splatDetailNormalTextureBM.Load(mapInfo->smf.splatDetailNormalTexNames[i])) {
+		if (!TakeMapBitmap(SMF_BITMAP_SPLAT_DETAIL_NORMAL + i, splatDetailNormalTextureBM)) {
 			splatDetailNormalTextureBM.Alloc(1, 1, 4);
 			splatDetailNormalTextureBM.GetRawMem()[0] = 127; // RGB is packed standard normal map
 			splatDetailNormalTextureBM.GetRawMem()[1] = 127;
@@ -315,7 +423,7 @@ void CSMFReadMap::CreateGrassTex()
 
 	CBitmap grassShadingTexBM;
 
-	if (!grassShadingTexBM.Load(mapInfo->smf.grassShadingTexName))
+	if (!TakeMapBitmap(SMF_BITMAP_GRASS_SHADING, grassShadingTexBM))
 		return;
 
 	// override minimap
@@ -329,7 +437,7 @@ void CSMFReadMap::CreateDetailTex()
 	RECOIL_DETAILED_TRACY_ZONE;
 	CBitmap detailTexBM;
 
-	if (!detailTexBM.Load(mapInfo->smf.detailTexName)) {
+	if (!TakeMapBitmap(SMF_BITMAP_DETAIL, detailTexBM)) {
 		LOG_L(L_WARNING, "[CSMFReadMap::%s] Invalid SMF detailTex %s. Creating fallback texture", __func__, mapInfo->smf.detailTexName.c_str());
 		detailTexBM.AllocDummy({127, 127, 127, 0});
 	}
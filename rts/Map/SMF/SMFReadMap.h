@@ -3,7 +3,9 @@
 #pragma once
 
 #include <array>
+#include <future>
 #include <memory>
+#include <vector>
 
 #include "SMFMapFile.h"
 #include "Map/ReadMap.h"
@@ -11,6 +13,7 @@
 #include "System/type2.h"
 
 
+class CBitmap;
 class CSMFGroundDrawer;
 class FBO;
 namespace Shader {
@@ -157,6 +160,9 @@ private:
 	void UpdateHeightMapUnsyncedPost() override;
 
 	void ParseHeader();
+	void LoadMapBitmaps();
+	void WaitMapBitmaps();
+	bool TakeMapBitmap(int bitmapIdx, CBitmap& bitmap);
 	void LoadHeightMap();
 	void LoadMinimap();
 	void CreateSpecularTex();
@@ -229,6 +235,11 @@ private:
 	MapTexture parallaxHeightTex;
 
 	MapTexture heightMapTexture;
+
+	// images decoded on the thread-pool while the heightmap is loaded,
+	// only in use during construction
+	std::vector<CBitmap> mapBitmaps;
+	std::vector<std::shared_future<bool>> mapBitmapLoads;
 private:
 	float texAnisotropyLevels[2] = {0.0f, 0.0f};
 
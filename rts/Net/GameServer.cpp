@@ -468,6 +468,9 @@ bool CGameServer::SendDemoData(int targetFrameNum)
 
 		const unsigned msgCode = buf->data[0];
 
+		// frames already simulated by the demo keyframe (savegame) the clients loaded
+		const bool keyFrameData = (serverFrameNum > 0 && serverFrameNum < myGameSetup->demoStartFrame);
+
 		switch (msgCode) {
 			case NETMSG_NEWFRAME:
 			case NETMSG_KEYFRAME: {
@@ -475,6 +478,9 @@ bool CGameServer::SendDemoData(int targetFrameNum)
 				lastNewFrameTick = spring_gettime();
 				serverFrameNum++;
 
+				if (serverFrameNum <= myGameSetup->demoStartFrame)
+					break;
+
 #ifdef SYNCCHECK
 				if (targetFrameNum == -1) {
 					// not skipping
@@ -523,11 +529,13 @@ bool CGameServer::SendDemoData(int targetFrameNum)
 					Message(spring::format("Warning: Discarding invalid command message packet in demo: %s", ex.what()));
 					continue;
 				}
-				Broadcast(rpkt);
+				if (!keyFrameData)
+					Broadcast(rpkt);
 				break;
 			}
 			default: {
-				Broadcast(rpkt);
+				if (!keyFrameData)
+					Broadcast(rpkt);
 				break;
 			}
 		}
@@ -2196,6 +2204,13 @@ void CGameServer::StartGame(bool forced)
 		// the client told us to start a demo
 		// no need to send startPos and startplaying since its in the demo
 		Message(DemoStart);
+
+		// clients resumed from a demo keyframe, fast-read past the frames it contains
+		// pre-game data and new players are still sent, everything else is dropped
+		while (serverFrameNum < myGameSetup->demoStartFrame && SendDemoData(myGameSetup->demoStartFrame)) {
+			modGameTime = demoReader->GetModGameTime() + 0.001f;
+		}
+
 		return;
 	}
 
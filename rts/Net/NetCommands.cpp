@@ -34,6 +34,7 @@
 #include "System/SpringMath.h"
 #include "System/TimeProfiler.h"
 #include "System/LoadSave/DemoRecorder.h"
+#include "System/LoadSave/LoadSaveHandler.h"
 #include "System/Net/UnpackPacket.h"
 #include "System/Sound/ISound.h"
 #include "System/Sync/DumpState.h"
@@ -274,6 +275,10 @@ void CGame::ClientReadNet()
 			break;
 		if (spring_gettime() > msgProcEndTime)
 			break;
+		// a queued demo keyframe must hold exactly the state of the frame it
+		// is named after, leave the remaining packets until it has been saved
+		if (globalSaveFileData.demoKeyFrame)
+			break;
 
 		lastNetPacketProcessTime = spring_gettime();
 
@@ -167,6 +167,9 @@ inline void CModelDrawerDataBase<T>::UpdateObjectSMMA(const T* o)
 	if (tmNew != tmOld)
 		smma[0] = tmNew;
 
+	// resolve all dirty pieces parents-first rather than through the lazy getters
+	o->localModel.UpdatePieceMatrices();
+
 	for (int i = 0; i < o->localModel.pieces.size(); ++i) {
 		const LocalModelPiece& lmp = o->localModel.pieces[i];
 		const bool wasCustomDirty = lmp.SetGetCustomDirty(false);
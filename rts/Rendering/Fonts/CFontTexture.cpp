@@ -2,6 +2,7 @@
 
 #include "CFontTexture.h"
 #include "glFontRenderer.h"
+#include "GlyphCache.h"
 #include "FontLogSection.h"
 
 #include <cstring> // for memset, memcpy
@@ -31,6 +32,7 @@
 	#include "System/Platform/Threading.h"
 #endif
 #include "System/SafeUtil.h"
+#include "System/SpringHash.h"
 #include "System/StringUtil.h"
 #include "System/TimeProfiler.h"
 #include "System/UnorderedMap.hpp"
@@ -439,8 +441,110 @@ static std::shared_ptr<FontFace> GetRenderFontFace(const std::string& fontfile,
 	if ((error = FT_Select_Charmap(facePtr->face, FT_ENCODING_UNICODE)) != 0) {
 		throw content_error(fmt::format("FT_Select_Charmap failed: {}", GetFTError(error)));
 	}
+
+	// key the glyph cache by file contents, rasterization may change between FreeType versions
+	{
+		static constexpr uint64_t ftVersion = (FREETYPE_MAJOR << 16) | (FREETYPE_MINOR << 8) | FREETYPE_PATCH;
+		FontFileBytes& fontMem = *facePtr->memory;
+
+		facePtr->glyphCache = CGlyphCache::Create(XXH3_64bits_withSeed(fontMem.data(), fontMem.size(), ftVersion), size);
+	}
+
 	return (fontFaceCache[fontKey] = facePtr).lock();
 }
+
+
+// copies the metrics and bitmap of the glyph last loaded into <slot>, returns an error message if unusable
+static const char* ReadGlyphSlot(const FT_GlyphSlot slot, CGlyphCache::Glyph& glyph, const uint8_t*& bitmap)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	glyph = {};
+	glyph.bearingX = slot->metrics.horiBearingX;
+	glyph.bearingY = slot->metrics.horiBearingY;
+	glyph.width    = slot->metrics.width;
+	glyph.height   = slot->metrics.height;
+	glyph.advance  = slot->advance.x;
+
+	bitmap = nullptr;
+
+	const int width  = slot->bitmap.width;
+	const int height = slot->bitmap.rows;
+
+	// eg. whitespace, only has metrics
+	if (width <= 0 || height <= 0)
+		return nullptr;
+
+	if (slot->bitmap.pixel_mode != FT_PIXEL_MODE_GRAY)
+		return "invalid pixeldata mode";
+
+	if (slot->bitmap.pitch != width)
+		return "invalid pitch";
+
+	if (width > 0xFFFF || height > 0xFFFF)
+		return "invalid size";
+
+	glyph.bmpWidth  = width;
+	glyph.bmpHeight = height;
+
+	bitmap = slot->bitmap.buffer;
+	return nullptr;
+}
+
+
+// code point ranges [first, last) rasterized ahead of use, skipped where the face has no glyphs
+static constexpr std::pair<char32_t, char32_t> preRasterizedRanges[] = {
+	{0x00A0, 0x0180}, // Latin-1 Supplement, Latin Extended-A
+	{0x0370, 0x0500}, // Greek, Cyrillic
+	{0x2000, 0x2070}, // General Punctuation
+	{0x3000, 0x3100}, // CJK Symbols and Punctuation, Hiragana, Katakana
+};
+
+static void PreRasterizeGlyphRanges(const std::shared_ptr<FontFileBytes>& fontMem, const std::shared_ptr<CGlyphCache>& glyphCache, int size)
+{
+	ZoneScopedN("CFontTexture::PreRasterizeGlyphRanges");
+
+	// FreeType objects must not be shared between threads, use a private library and face
+	FT_Library lib_ = nullptr;
+
+	if (FT_Init_FreeType(&lib_) != 0)
+		return;
+
+	// also frees the face
+	auto lib = spring::ScopedResource(
+		lib_,
+		[](FT_Library l) { FT_Done_FreeType(l); }
+	);
+
+	FT_Face face = nullptr;
+
+	if (FT_New_Memory_Face(lib, fontMem->data(), fontMem->size(), 0, &face) != 0)
+		return;
+	if (FT_Set_Pixel_Sizes(face, 0, size) != 0)
+		return;
+	if (FT_Select_Charmap(face, FT_ENCODING_UNICODE) != 0)
+		return;
+
+	CGlyphCache::Glyph glyph;
+	const uint8_t* bitmap = nullptr;
+
+	for (const auto& [first, last]: preRasterizedRanges) {
+		for (char32_t c = first; c < last; ++c) {
+			if (glyphCache->IsPreloadStopped())
+				return;
+
+			const FT_UInt index = FT_Get_Char_Index(face, c);
+
+			if (index == 0 || glyphCache->Contains(index))
+				continue;
+			if (FT_Load_Glyph(face, index, FT_LOAD_RENDER) != 0)
+				continue;
+			if (ReadGlyphSlot(face->glyph, glyph, bitmap) != nullptr)
+				continue;
+
+			glyphCache->Insert(index, glyph, bitmap);
+		}
+	}
+}
 #endif
 
 
@@ -697,6 +801,9 @@ CFontTexture::CFontTexture(const std::string& fontfile, int size, int _outlinesi
 	// precache ASCII glyphs & kernings (save them in kerningPrecached array for better lvl2 cpu cache hitrate)
 	PreloadGlyphs();
 
+	// warm the glyph cache with other common scripts, they still enter the atlas on first use
+	PreRasterizeGlyphs();
+
 #endif
 }
 
@@ -729,6 +836,21 @@ void CFontTexture::PreloadGlyphs()
 #endif
 }
 
+void CFontTexture::PreRasterizeGlyphs()
+{
+#ifndef HEADLESS
+	const std::shared_ptr<CGlyphCache>& glyphCache = shFace->glyphCache;
+
+	// fonts sharing a face (eg. with different outlines) share its cache too
+	if (glyphCache == nullptr || !glyphCache->MarkPreloadQueued())
+		return;
+
+	ThreadPool::Enqueue([fontMem = shFace->memory, glyphCache, size = fontSize]() {
+		PreRasterizeGlyphRanges(fontMem, glyphCache, size);
+	});
+#endif
+}
+
 CFontTexture::~CFontTexture()
 {
 	RECOIL_DETAILED_TRACY_ZONE;
@@ -916,6 +1038,8 @@ void CFontTexture::InitFonts()
 #ifndef HEADLESS
 	maxFontTries = configHandler ? configHandler->GetInt("MaxFontTries") : 5;
 	maxPinnedFonts = configHandler ? configHandler->GetInt("MaxPinnedFonts") : 10;
+
+	CGlyphCache::Init(configHandler ? configHandler->GetBool("FontGlyphCache") : false);
 #endif
 }
 
@@ -1163,47 +1287,55 @@ void CFontTexture::LoadGlyph(std::shared_ptr<FontFace>& f, char32_t ch, unsigned
 	glyph.index = index;
 	glyph.letter = ch;
 
-	// load glyph
-	if (FT_Load_Glyph(*f, index, FT_LOAD_RENDER) != 0)
-		LOG_L(L_ERROR, "Couldn't load glyph %d", ch);
+	// CBitmap copies the glyph bitmap below, this only has to outlive it
+	std::vector<uint8_t> cachedBitmap;
 
-	FT_GlyphSlot slot = f->face->glyph;
+	CGlyphCache::Glyph rasterGlyph;
+	const uint8_t* bitmap = nullptr;
+
+	if (f->glyphCache != nullptr && f->glyphCache->Find(index, rasterGlyph, cachedBitmap)) {
+		bitmap = cachedBitmap.data();
+	} else {
+		// load glyph
+		const bool loaded = (FT_Load_Glyph(*f, index, FT_LOAD_RENDER) == 0);
+
+		if (!loaded)
+			LOG_L(L_ERROR, "Couldn't load glyph %d", ch);
+
+		if (const char* error = ReadGlyphSlot(f->face->glyph, rasterGlyph, bitmap); error != nullptr) {
+			LOG_L(L_ERROR, "%s", error);
+			rasterGlyph.bmpWidth = 0;
+			rasterGlyph.bmpHeight = 0;
+		} else if (loaded && f->glyphCache != nullptr) {
+			f->glyphCache->Insert(index, rasterGlyph, bitmap);
+		}
+	}
 
-	const float xbearing = slot->metrics.horiBearingX * normScale;
-	const float ybearing = slot->metrics.horiBearingY * normScale;
+	const float xbearing = rasterGlyph.bearingX * normScale;
+	const float ybearing = rasterGlyph.bearingY * normScale;
 
 	glyph.size.x = xbearing;
 	glyph.size.y = ybearing - fontDescender;
-	glyph.size.w =  slot->metrics.width * normScale;
-	glyph.size.h = -slot->metrics.height * normScale;
+	glyph.size.w =  rasterGlyph.width * normScale;
+	glyph.size.h = -rasterGlyph.height * normScale;
 
-	glyph.advance   = slot->advance.x * normScale;
-	glyph.height    = slot->metrics.height * normScale;
+	glyph.advance   = rasterGlyph.advance * normScale;
+	glyph.height    = rasterGlyph.height * normScale;
 	glyph.descender = ybearing - glyph.height;
 
 	// workaround bugs in FreeSansBold (in range 0x02B0 - 0x0300)
 	if (glyph.advance == 0 && glyph.size.w > 0)
 		glyph.advance = glyph.size.w;
 
-	const int width  = slot->bitmap.width;
-	const int height = slot->bitmap.rows;
+	const int width  = rasterGlyph.bmpWidth;
+	const int height = rasterGlyph.bmpHeight;
 	const int olSize = 2 * outlineSize;
 
 	if (width <= 0 || height <= 0)
 		return;
 
-	if (slot->bitmap.pixel_mode != FT_PIXEL_MODE_GRAY) {
-		LOG_L(L_ERROR, "invalid pixeldata mode");
-		return;
-	}
-
-	if (slot->bitmap.pitch != width) {
-		LOG_L(L_ERROR, "invalid pitch");
-		return;
-	}
-
 	// store glyph bitmap (index) in allocator until the next LoadWantedGlyphs call
-	atlasGlyphs.emplace_back(slot->bitmap.buffer, width, height, 1);
+	atlasGlyphs.emplace_back(bitmap, width, height, 1);
 
 	atlasAlloc.AddEntry(IntToString(ch)       , int2(width         , height         ), reinterpret_cast<void*>(atlasGlyphs.size() - 1));
 	atlasAlloc.AddEntry(IntToString(ch) + "sh", int2(width + olSize, height + olSize)                                                 );
@@ -1441,6 +1573,10 @@ FontFace::~FontFace()
 {
 	RECOIL_DETAILED_TRACY_ZONE;
 #ifndef HEADLESS
+	// the pre-rasterization job has its own face, just tell it to quit early
+	if (glyphCache != nullptr)
+		glyphCache->StopPreload();
+
 	FT_Done_Face(face);
 #endif
 }
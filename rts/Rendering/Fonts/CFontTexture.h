@@ -17,6 +17,7 @@
 struct FT_FaceRec_;
 typedef struct FT_FaceRec_* FT_Face;
 class CBitmap;
+class CGlyphCache;
 
 class FtLibraryHandlerProxy {
 public:
@@ -61,6 +62,7 @@ struct FontFileBytes {
 	}
 	using FT_Byte = unsigned char;
 	FT_Byte* data();
+	size_t size() const { return vec.size(); }
 private:
 	std::vector<FT_Byte> vec;
 };
@@ -73,6 +75,8 @@ struct FontFace {
 
 	FT_Face face;
 	std::shared_ptr<FontFileBytes> memory;
+	// rasterized glyphs of this face at its render size, may be null
+	std::shared_ptr<CGlyphCache> glyphCache;
 };
 
 struct GlyphInfo {
@@ -152,6 +156,7 @@ private:
 	void LoadGlyph(std::shared_ptr<FontFace>& f, char32_t ch, unsigned index);
 	bool ClearGlyphs();
 	void PreloadGlyphs();
+	void PreRasterizeGlyphs();
 protected:
 	float GetKerning(const GlyphInfo& lgl, const GlyphInfo& rgl);
 protected:
@@ -0,0 +1,209 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "GlyphCache.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "System/StringUtil.h"
+#include "System/FileSystem/DataDirsAccess.h"
+#include "System/FileSystem/FileQueryFlags.h"
+#include "System/FileSystem/FileSystem.h"
+#include "System/FileSystem/FileSystemAbstraction.h"
+#include "System/Log/ILog.h"
+
+#include "System/Misc/TracyDefs.h"
+
+// set once at startup, empty if glyphs should not be cached
+static std::string glyphCacheDir;
+
+namespace {
+	struct GlyphCacheHeader {
+		char magic[8];
+		uint64_t faceHash;
+
+		int32_t pixelSize;
+		uint32_t numGlyphs;
+		uint64_t numBitmapBytes;
+	};
+
+	struct GlyphCacheEntry {
+		uint32_t index;
+		CGlyphCache::Glyph glyph;
+	};
+
+	constexpr char GLYPH_CACHE_MAGIC[8] = "RGLYPH1";
+
+	// a fallback face covering a whole script can accumulate many glyphs over
+	// time; stop adding once this much bitmap data is cached for one face+size
+	constexpr size_t GLYPH_CACHE_MAX_BITMAP_BYTES = 16 * 1024 * 1024;
+}
+
+
+CGlyphCache::CGlyphCache(uint64_t faceHash_, int pixelSize_)
+	: faceHash(faceHash_)
+	, pixelSize(pixelSize_)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	char hexHash[16 + 1];
+	std::snprintf(hexHash, sizeof(hexHash), "%016llx", static_cast<unsigned long long>(faceHash));
+
+	fileName = glyphCacheDir + hexHash + "-" + IntToString(pixelSize) + ".glyphs";
+
+	if (!Load()) {
+		glyphs.clear();
+		bitmaps.clear();
+	}
+}
+
+CGlyphCache::~CGlyphCache()
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	if (dirty)
+		Save();
+}
+
+
+void CGlyphCache::Init(bool enable)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	glyphCacheDir.clear();
+
+	if (!enable)
+		return;
+
+	glyphCacheDir = dataDirsAccess.LocateDir(FileSystem::GetCacheDir() + FileSystemAbstraction::GetNativePathSeparator() + "fonts" + FileSystemAbstraction::GetNativePathSeparator(), FileQueryFlags::WRITE | FileQueryFlags::CREATE_DIRS);
+}
+
+std::shared_ptr<CGlyphCache> CGlyphCache::Create(uint64_t faceHash, int pixelSize)
+{
+	if (glyphCacheDir.empty())
+		return nullptr;
+
+	return std::make_shared<CGlyphCache>(faceHash, pixelSize);
+}
+
+
+bool CGlyphCache::Contains(uint32_t index) const
+{
+	std::lock_guard<spring::mutex> lck(mutex);
+	return glyphs.contains(index);
+}
+
+bool CGlyphCache::Find(uint32_t index, Glyph& glyph, std::vector<uint8_t>& bitmap) const
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	std::lock_guard<spring::mutex> lck(mutex);
+
+	const auto it = glyphs.find(index);
+
+	if (it == glyphs.end())
+		return false;
+
+	glyph = it->second;
+
+	const auto bmpBeg = bitmaps.begin() + glyph.bmpOffset;
+	const auto bmpEnd = bmpBeg + glyph.bmpWidth * glyph.bmpHeight;
+
+	bitmap.assign(bmpBeg, bmpEnd);
+	return true;
+}
+
+void CGlyphCache::Insert(uint32_t index, const Glyph& glyph, const uint8_t* bitmap)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	const size_t bmpSize = glyph.bmpWidth * glyph.bmpHeight;
+
+	std::lock_guard<spring::mutex> lck(mutex);
+
+	if (glyphs.contains(index))
+		return;
+	if ((bitmaps.size() + bmpSize) > GLYPH_CACHE_MAX_BITMAP_BYTES)
+		return;
+
+	Glyph& cachedGlyph = (glyphs[index] = glyph);
+
+	cachedGlyph.bmpOffset = bitmaps.size();
+	bitmaps.insert(bitmaps.end(), bitmap, bitmap + bmpSize);
+
+	dirty = true;
+}
+
+size_t CGlyphCache::GetNumGlyphs() const
+{
+	std::lock_guard<spring::mutex> lck(mutex);
+	return glyphs.size();
+}
+
+
+bool CGlyphCache::Load()
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	FILE* file = std::fopen(fileName.c_str(), "rb");
+
+	if (file == nullptr)
+		return false;
+
+	GlyphCacheHeader header;
+	bool valid = (std::fread(&header, sizeof(header), 1, file) == 1);
+
+	valid = valid && (std::memcmp(header.magic, GLYPH_CACHE_MAGIC, sizeof(header.magic)) == 0);
+	valid = valid && (header.faceHash == faceHash && header.pixelSize == pixelSize);
+	valid = valid && (header.numBitmapBytes <= GLYPH_CACHE_MAX_BITMAP_BYTES);
+
+	std::vector<GlyphCacheEntry> entries;
+
+	if (valid) {
+		entries.resize(header.numGlyphs);
+		bitmaps.resize(header.numBitmapBytes);
+
+		valid = valid && (entries.empty() || std::fread(entries.data(), sizeof(GlyphCacheEntry), entries.size(), file) == entries.size());
+		valid = valid && (bitmaps.empty() || std::fread(bitmaps.data(), bitmaps.size(), 1, file) == 1);
+	}
+
+	std::fclose(file);
+
+	if (!valid) {
+		LOG_L(L_WARNING, "[GlyphCache::%s] ignoring invalid cache file \"%s\"", __func__, fileName.c_str());
+		return false;
+	}
+
+	glyphs.reserve(entries.size());
+
+	for (const GlyphCacheEntry& entry: entries) {
+		// never trust offsets read from disk
+		if ((size_t(entry.glyph.bmpOffset) + entry.glyph.bmpWidth * entry.glyph.bmpHeight) > bitmaps.size())
+			return false;
+
+		glyphs[entry.index] = entry.glyph;
+	}
+
+	return true;
+}
+
+void CGlyphCache::Save() const
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	std::vector<GlyphCacheEntry> entries;
+	entries.reserve(glyphs.size());
+
+	for (const auto& [index, glyph]: glyphs) {
+		entries.push_back({index, glyph});
+	}
+
+	GlyphCacheHeader header = {};
+
+	std::memcpy(header.magic, GLYPH_CACHE_MAGIC, sizeof(header.magic));
+	header.faceHash = faceHash;
+	header.pixelSize = pixelSize;
+	header.numGlyphs = entries.size();
+	header.numBitmapBytes = bitmaps.size();
+
+	// another running instance may be loading (or saving) the same face at the same time
+	FileSystem::WriteFileAtomic(fileName, [&](FILE* file) {
+		bool written = (std::fwrite(&header, sizeof(header), 1, file) == 1);
+		written = written && (entries.empty() || std::fwrite(entries.data(), sizeof(GlyphCacheEntry), entries.size(), file) == entries.size());
+		written = written && (bitmaps.empty() || std::fwrite(bitmaps.data(), bitmaps.size(), 1, file) == 1);
+		return written;
+	});
+}
@@ -0,0 +1,83 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _GLYPH_CACHE_H
+#define _GLYPH_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "System/UnorderedMap.hpp"
+#include "System/Threading/SpringThreading.h"
+
+
+/**
+Rasterized glyphs of one font face at one pixel size, keyed by glyph index.
+Persisted to <cache>/fonts between runs so that text in new scripts (e.g.
+CJK chat) does not stall on FreeType the first time it is shown.
+Knows nothing about FreeType, metrics are stored in its 26.6 format.
+**/
+class CGlyphCache
+{
+public:
+	struct Glyph {
+		int32_t bearingX = 0;
+		int32_t bearingY = 0;
+		int32_t width    = 0;
+		int32_t height   = 0;
+		int32_t advance  = 0;
+
+		// 8bit coverage bitmap, tightly packed (pitch == bmpWidth)
+		uint16_t bmpWidth  = 0;
+		uint16_t bmpHeight = 0;
+		uint32_t bmpOffset = 0;
+	};
+
+public:
+	// <faceHash> identifies the font file contents (and rasterizer version)
+	CGlyphCache(uint64_t faceHash, int pixelSize);
+	~CGlyphCache();
+
+	CGlyphCache(const CGlyphCache&) = delete;
+	CGlyphCache& operator = (const CGlyphCache&) = delete;
+
+	static void Init(bool enable);
+	// returns nullptr if the cache is disabled
+	static std::shared_ptr<CGlyphCache> Create(uint64_t faceHash, int pixelSize);
+
+	bool Contains(uint32_t index) const;
+	bool Find(uint32_t index, Glyph& glyph, std::vector<uint8_t>& bitmap) const;
+	void Insert(uint32_t index, const Glyph& glyph, const uint8_t* bitmap);
+
+	// the first caller gets to queue the background rasterization
+	bool MarkPreloadQueued() { return !preloadQueued.exchange(true); }
+	void StopPreload() { preloadStopped = true; }
+	bool IsPreloadStopped() const { return preloadStopped; }
+
+	size_t GetNumGlyphs() const;
+
+private:
+	bool Load();
+	void Save() const;
+
+private:
+	std::string fileName;
+
+	uint64_t faceHash;
+	int pixelSize;
+
+	spring::unordered_map<uint32_t, Glyph> glyphs;
+	std::vector<uint8_t> bitmaps;
+
+	mutable spring::mutex mutex;
+
+	std::atomic<bool> preloadQueued = {false};
+	std::atomic<bool> preloadStopped = {false};
+
+	// set when glyphs were added since the last Load
+	bool dirty = false;
+};
+
+#endif // _GLYPH_CACHE_H
@@ -49,6 +49,7 @@ CR_REG_METADATA(LocalModel, (
 
 	CR_MEMBER(boundingVolume),
 	CR_IGNORED(luaMaterialData),
+	CR_IGNORED(pieceOrder),
 	CR_MEMBER(needsBoundariesRecalc)
 ))
 
@@ -334,6 +335,7 @@ void LocalModel::SetModel(const S3DModel* model, bool initialize)
 			pieces[n].original = omp;
 		}
 
+		UpdatePieceOrder();
 		pieces[0].UpdateChildMatricesRec(true);
 		UpdateBoundingVolume();
 		return;
@@ -345,11 +347,12 @@ void LocalModel::SetModel(const S3DModel* model, bool initialize)
 	pieces.reserve(model->numPieces);
 
 	CreateLocalModelPieces(model->GetRootPiece());
+	UpdatePieceOrder();
 
-	// must recursively update matrices here too: for features
-	// LocalModel::Update is never called, but they might have
-	// baked piece rotations (in the case of .dae)
-	pieces[0].UpdateChildMatricesRec(false);
+	// must update matrices here too: for features LocalModel::Update
+	// is never called, but they might have baked piece rotations (in
+	// the case of .dae)
+	UpdatePieceMatrices();
 	UpdateBoundingVolume();
 
 	assert(pieces.size() == model->numPieces);
@@ -381,6 +384,53 @@ LocalModelPiece* LocalModel::CreateLocalModelPieces(const S3DModelPiece* mpParen
 	return lmpParent;
 }
 
+void LocalModel::UpdatePieceOrder()
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	pieceOrder.clear();
+	pieceOrder.reserve(pieces.size());
+	pieceOrder.push_back(0);
+
+	// children are appended after their parent, so a breadth-first walk
+	// over the list itself yields a valid parents-first order
+	for (size_t i = 0; i < pieceOrder.size(); i++) {
+		for (const LocalModelPiece* child: pieces[pieceOrder[i]].children) {
+			pieceOrder.push_back(child->GetLModelPieceIndex());
+		}
+	}
+
+	assert(pieceOrder.size() == pieces.size());
+}
+
+void LocalModel::UpdatePieceMatrices() const
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	// every piece is visited once, a dirty parent always precedes its
+	// (equally dirty) children so nothing is recalculated twice
+	for (unsigned int pieceIdx: pieceOrder) {
+		pieces[pieceIdx].UpdateMatrices();
+	}
+}
+
+bool LocalModel::SetPieceParent(LocalModelPiece* childPiece, LocalModelPiece* parentPiece)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	for (const LocalModelPiece* lmp = parentPiece; lmp != nullptr; lmp = lmp->parent) {
+		if (lmp == childPiece)
+			return false;
+	}
+
+	childPiece->parent->RemoveChild(childPiece);
+	childPiece->SetParent(parentPiece);
+	parentPiece->AddChild(childPiece);
+
+	// the subtree now hangs off a different model-space matrix
+	childPiece->SetDirty();
+	SetBoundariesNeedsRecalc();
+	UpdatePieceOrder();
+	return true;
+}
+
 
 void LocalModel::UpdateBoundingVolume()
 {
@@ -518,6 +568,11 @@ void LocalModelPiece::UpdateParentMatricesRec() const
 	if (parent != nullptr && parent->dirty)
 		parent->UpdateParentMatricesRec();
 
+	CalcMatrices();
+}
+
+void LocalModelPiece::CalcMatrices() const
+{
 	dirty = false;
 
 	pieceSpaceMat = CalcPieceSpaceMatrix(pos, rot, original->scales);
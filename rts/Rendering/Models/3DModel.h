@@ -484,6 +484,8 @@ struct LocalModelPiece
 	// on-demand functions
 	void UpdateChildMatricesRec(bool updateChildMatrices) const;
 	void UpdateParentMatricesRec() const;
+	// non-recursive; the parent must already be up-to-date
+	void UpdateMatrices() const { if (dirty) CalcMatrices(); }
 
 	CMatrix44f CalcPieceSpaceMatrixRaw(const float3& p, const float3& r, const float3& s) const { return (original->ComposeTransform(p, r, s)); }
 	CMatrix44f CalcPieceSpaceMatrix(const float3& p, const float3& r, const float3& s) const {
@@ -531,6 +533,9 @@ struct LocalModelPiece
 
 	bool GetScriptVisible() const { return scriptSetVisible; }
 	void SetScriptVisible(bool b) { scriptSetVisible = b; SetGetCustomDirty(true); }
+private:
+	void CalcMatrices() const;
+
 private:
 	float3 pos; // translation relative to parent LMP, *INITIALLY* equal to original->offset
 	float3 rot; // orientation relative to parent LMP, in radians (updated by scripts)
@@ -602,6 +607,10 @@ struct LocalModel
 	void SetModel(const S3DModel* model, bool initialize = true);
 	void SetLODCount(unsigned int lodCount);
 	void UpdateBoundingVolume();
+	// recalculates the matrices of all dirty pieces in one pass, parents first
+	void UpdatePieceMatrices() const;
+	// fails if <parentPiece> is part of the subtree below <childPiece>
+	bool SetPieceParent(LocalModelPiece* childPiece, LocalModelPiece* parentPiece);
 
 	void GetBoundingBoxVerts(std::vector<float3>& verts) const {
 		verts.resize(8 + 2); GetBoundingBoxVerts(&verts[0]);
@@ -630,6 +639,7 @@ struct LocalModel
 	bool GetBoundariesNeedsRecalc() const { return needsBoundariesRecalc; }
 private:
 	LocalModelPiece* CreateLocalModelPieces(const S3DModelPiece* mpParent);
+	void UpdatePieceOrder();
 
 	void DrawPieces() const;
 	void DrawPiecesLOD(unsigned int lod) const;
@@ -644,6 +654,10 @@ private:
 	// custom Lua-set material this model should be rendered with
 	LuaObjectMaterialData luaMaterialData;
 
+	// piece indices ordered parents-first; unlike the storage order of
+	// <pieces> this stays valid when pieces are re-parented by Lua
+	std::vector<unsigned int> pieceOrder;
+
 	bool needsBoundariesRecalc = true;
 };
 
@@ -3,7 +3,9 @@
 #include <algorithm>
 #include <bit>
 #include <utility>
+#include <cstdio>
 #include <cstring>
+#include <filesystem>
 #include <memory>
 #include <span>
 
@@ -23,6 +25,7 @@
 #include "System/SafeUtil.h"
 #include "System/Log/ILog.h"
 #include "System/SpringMem.h"
+#include "System/SpringHash.h"
 #include "System/SpringMath.h"
 #include "System/StringUtil.h"
 #include "System/Threading/ThreadPool.h"
@@ -30,6 +33,7 @@
 #include "System/FileSystem/FileQueryFlags.h"
 #include "System/FileSystem/FileHandler.h"
 #include "System/FileSystem/FileSystem.h"
+#include "System/FileSystem/FileSystemAbstraction.h"
 #include "System/Threading/SpringThreading.h"
 
 #include "System/Misc/TracyDefs.h"
@@ -39,6 +43,13 @@ struct InitializeOpenIL {
 	~InitializeOpenIL() { ilShutDown(); }
 } static initOpenIL;
 
+// libIL keeps global state (bound image, origin, errors) and is not thread-safe;
+// pool allocations are locked separately so they never wait for a decode
+static spring::mutex ilMutex;
+
+// set once at startup, empty if decoded images should not be cached
+static std::string decodeCacheDir;
+
 class TexMemPool;
 class TexNoMemPool;
 
@@ -86,7 +97,7 @@ protected:
 	size_t numFrees = 0;
 	size_t freeSize = 0;
 
-	// libIL is not thread-safe, neither are {Alloc,Free}
+	// {Alloc,Free}Raw are not thread-safe
 	spring::mutex bmpMutex;
 };
 
@@ -383,6 +394,153 @@ static bool IsValidImageFormat(int format) {
 
 
 
+//////////////////////////////////////////////////////////////////////
+// Decode cache
+//////////////////////////////////////////////////////////////////////
+
+namespace {
+	struct DecodeCacheHeader {
+		char magic[8];
+		uint64_t srcHash;
+
+		int32_t xsize;
+		int32_t ysize;
+		int32_t channels;
+		uint32_t dataType;
+		uint32_t hasAlpha;
+		uint32_t padding;
+	};
+
+	constexpr char DECODE_CACHE_MAGIC[8] = "RBMPDC1";
+
+	// below this the file is decoded about as fast as the entry can be read
+	constexpr size_t DECODE_CACHE_MIN_FILE_SIZE = 16 * 1024;
+
+	// entries are keyed by the hash of the encoded file contents and the
+	// requested conversion, so renamed or duplicated images share an entry
+	std::string GetDecodeCacheFileName(const std::vector<uint8_t>& buffer, uint64_t& srcHash, uint32_t reqChannel, uint32_t reqDataType)
+	{
+		if (decodeCacheDir.empty() || buffer.size() < DECODE_CACHE_MIN_FILE_SIZE)
+			return "";
+
+		srcHash = XXH3_64bits_withSeed(buffer.data(), buffer.size(), (uint64_t(reqDataType) << 32) | reqChannel);
+
+		char hexHash[16 + 1];
+		std::snprintf(hexHash, sizeof(hexHash), "%016llx", static_cast<unsigned long long>(srcHash));
+
+		return (decodeCacheDir + hexHash + ".bmp.cache");
+	}
+
+	// <bmpMemSize> tracks the size of the memory held by <bmp>, which the entry may have reallocated before a read error
+	bool LoadDecodeCacheEntry(CBitmap& bmp, const std::string& fileName, uint64_t srcHash, bool& hasAlpha, size_t& bmpMemSize)
+	{
+		RECOIL_DETAILED_TRACY_ZONE;
+		FILE* file = std::fopen(fileName.c_str(), "rb");
+
+		if (file == nullptr)
+			return false;
+
+		DecodeCacheHeader header;
+		bool valid = (std::fread(&header, sizeof(header), 1, file) == 1);
+
+		valid = valid && (std::memcmp(header.magic, DECODE_CACHE_MAGIC, sizeof(header.magic)) == 0);
+		valid = valid && (header.srcHash == srcHash);
+		valid = valid && (header.xsize > 0 && header.ysize > 0);
+		valid = valid && (header.channels >= 1 && header.channels <= 4);
+		valid = valid && (CBitmap::GetDataTypeSize(header.dataType) != 0);
+
+		// truncated or padded entries are rejected before touching the bitmap
+		const uint64_t dataSize = uint64_t(header.xsize) * header.ysize * header.channels * CBitmap::GetDataTypeSize(header.dataType);
+		valid = valid && (FileSystem::GetFileSize(fileName) == (sizeof(header) + dataSize));
+
+		if (valid) {
+			bmp.Alloc(header.xsize, header.ysize, header.channels, header.dataType);
+			bmpMemSize = bmp.GetMemSize();
+
+			valid = (std::fread(bmp.GetRawMem(), bmp.GetMemSize(), 1, file) == 1);
+			hasAlpha = (header.hasAlpha != 0);
+		}
+
+		std::fclose(file);
+
+		if (!valid) {
+			LOG_L(L_WARNING, "[BMP::%s] removing corrupt decode cache entry \"%s\"", __func__, fileName.c_str());
+			std::remove(fileName.c_str());
+			return false;
+		}
+
+		// keep recently used entries from being evicted
+		std::error_code ec;
+		std::filesystem::last_write_time(fileName, std::filesystem::file_time_type::clock::now(), ec);
+		return true;
+	}
+
+	// removes the least recently used entries until the cache is at most <maxSize> bytes
+	void TrimDecodeCache(size_t maxSize)
+	{
+		RECOIL_DETAILED_TRACY_ZONE;
+		struct CacheFile {
+			std::filesystem::path path;
+			std::filesystem::file_time_type time;
+			uintmax_t size;
+		};
+
+		std::vector<CacheFile> files;
+		std::error_code ec;
+
+		uintmax_t cacheSize = 0;
+
+		for (const auto& entry: std::filesystem::directory_iterator(decodeCacheDir, ec)) {
+			if (!entry.is_regular_file(ec))
+				continue;
+
+			files.push_back({entry.path(), entry.last_write_time(ec), entry.file_size(ec)});
+			cacheSize += files.back().size;
+		}
+
+		if (cacheSize <= maxSize)
+			return;
+
+		std::sort(files.begin(), files.end(), [](const CacheFile& a, const CacheFile& b) { return (a.time < b.time); });
+
+		size_t numRemoved = 0;
+
+		for (const CacheFile& file: files) {
+			if (cacheSize <= maxSize)
+				break;
+			if (!std::filesystem::remove(file.path, ec))
+				continue;
+
+			cacheSize -= file.size;
+			numRemoved += 1;
+		}
+
+		LOG_L(L_INFO, "[BMP::%s] removed %u decode cache entries, %u MB left", __func__, uint32_t(numRemoved), uint32_t(cacheSize / (1024 * 1024)));
+	}
+
+	void SaveDecodeCacheEntry(const CBitmap& bmp, const std::string& fileName, uint64_t srcHash, bool hasAlpha)
+	{
+		RECOIL_DETAILED_TRACY_ZONE;
+		DecodeCacheHeader header = {};
+
+		std::memcpy(header.magic, DECODE_CACHE_MAGIC, sizeof(header.magic));
+		header.srcHash = srcHash;
+		header.xsize = bmp.xsize;
+		header.ysize = bmp.ysize;
+		header.channels = bmp.channels;
+		header.dataType = bmp.dataType;
+		header.hasAlpha = hasAlpha;
+
+		// readers (possibly in other processes) must never see a partially written entry
+		FileSystem::WriteFileAtomic(fileName, [&](FILE* file) {
+			bool written = (std::fwrite(&header, sizeof(header), 1, file) == 1);
+			written = written && (std::fwrite(bmp.GetRawMem(), bmp.GetMemSize(), 1, file) == 1);
+			return written;
+		});
+	}
+}
+
+
 //////////////////////////////////////////////////////////////////////
 // BitmapAction
 //////////////////////////////////////////////////////////////////////
@@ -564,11 +722,22 @@ void TBitmapAction<T, ch>::ReplaceAlpha(float a)
 		return;
 	}
 
-	for (int32_t y = 0; y < bmp->ysize; ++y) {
-		int32_t yOffset = (y * bmp->xsize);
-		for (int32_t x = 0; x < bmp->xsize; ++x) {
-			auto& alpha = GetRef(yOffset + x, ch - 1);
-			alpha = static_cast<ChanType>(GetMaxNormValue() * a);
+	const ChanType alpha = static_cast<ChanType>(GetMaxNormValue() * a);
+	const size_t numPixels = size_t(bmp->xsize) * bmp->ysize;
+
+	// runs for every loaded image without alpha; keep the loops
+	// branch-free over raw memory so the compiler vectorizes them
+	if constexpr (std::is_same_v<T, uint8_t> && ch == 4 && std::endian::native == std::endian::little) {
+		uint32_t* pixels = reinterpret_cast<uint32_t*>(bmp->GetRawMem());
+
+		for (size_t i = 0; i < numPixels; ++i) {
+			pixels[i] = (pixels[i] & 0x00FFFFFFu) | (uint32_t(alpha) << 24);
+		}
+	} else {
+		ChanType* chans = reinterpret_cast<ChanType*>(bmp->GetRawMem());
+
+		for (size_t i = 0; i < numPixels; ++i) {
+			chans[i * ch + (ch - 1)] = alpha;
 		}
 	}
 }
@@ -785,6 +954,17 @@ void TBitmapAction<T, ch>::InvertColors()
 		return;
 	}
 
+	// 255 - x equals x ^ 255 for bytes, invert whole pixels at once
+	if constexpr (std::is_same_v<T, uint8_t> && ch == 4 && std::endian::native == std::endian::little) {
+		uint32_t* pixels = reinterpret_cast<uint32_t*>(bmp->GetRawMem());
+
+		for (size_t i = 0, n = size_t(bmp->xsize) * bmp->ysize; i < n; ++i) {
+			pixels[i] ^= 0x00FFFFFFu;
+		}
+
+		return;
+	}
+
 	for (int y = 0; y < bmp->ysize; ++y) {
 		uint32_t yOffset = (y * bmp->xsize);
 		for (int x = 0; x < bmp->xsize; ++x) {
@@ -806,6 +986,16 @@ void TBitmapAction<T, ch>::InvertAlpha()
 		return;
 	}
 
+	if constexpr (std::is_same_v<T, uint8_t> && ch == 4 && std::endian::native == std::endian::little) {
+		uint32_t* pixels = reinterpret_cast<uint32_t*>(bmp->GetRawMem());
+
+		for (size_t i = 0, n = size_t(bmp->xsize) * bmp->ysize; i < n; ++i) {
+			pixels[i] ^= 0xFF000000u;
+		}
+
+		return;
+	}
+
 	for (int y = 0; y < bmp->ysize; ++y) {
 		uint32_t yOffset = (y * bmp->xsize);
 		for (int x = 0; x < bmp->xsize; ++x) {
@@ -1079,6 +1269,21 @@ void CBitmap::InitPool(size_t size)
 	ITexMemPool::texMemPool->Defrag();
 }
 
+void CBitmap::InitDecodeCache(bool enable, size_t maxSize)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	decodeCacheDir.clear();
+
+	if (!enable)
+		return;
+
+	decodeCacheDir = dataDirsAccess.LocateDir(FileSystem::GetCacheDir() + FileSystemAbstraction::GetNativePathSeparator() + "bitmaps" + FileSystemAbstraction::GetNativePathSeparator(), FileQueryFlags::WRITE | FileQueryFlags::CREATE_DIRS);
+
+	// config-size is in MB
+	if (!decodeCacheDir.empty())
+		TrimDecodeCache(maxSize * 1024 * 1024);
+}
+
 void CBitmap::KillPool()
 {
 	RECOIL_DETAILED_TRACY_ZONE;
@@ -1231,7 +1436,7 @@ bool CBitmap::Load(std::string const& filename, float defaultAlpha, uint32_t req
 	const bool loadDDS = (FileSystem::GetExtension(filename) == "dds"); // always lower-case
 	const bool flipDDS = (filename.find("unitpics") == std::string::npos); // keep buildpics as-is
 
-	const size_t curMemSize = GetMemSize();
+	size_t curMemSize = GetMemSize();
 
 	channels = 4;
 	textype = GL_TEXTURE_2D;
@@ -1296,9 +1501,19 @@ bool CBitmap::Load(std::string const& filename, float defaultAlpha, uint32_t req
 		buffer = std::move(file.GetBuffer());
 	}
 
+	uint64_t srcHash = 0;
+	const std::string cacheFileName = GetDecodeCacheFileName(buffer, srcHash, reqChannel, reqDataType);
+
+	// a cached decode needs neither libIL nor its lock
+	if (!cacheFileName.empty() && LoadDecodeCacheEntry(*this, cacheFileName, srcHash, hasAlpha, curMemSize)) {
+		if (!hasAlpha || forceReplaceAlpha)
+			ReplaceAlpha(defaultAlpha);
+
+		return true;
+	}
 
 	{
-		std::scoped_lock lck(ITexMemPool::texMemPool->GetMutex());
+		std::scoped_lock lck(ilMutex);
 
 		// do not preserve the image origin since IL does not
 		// vertically flip DDS images by default, unlike nv_dds
@@ -1393,8 +1608,8 @@ bool CBitmap::Load(std::string const& filename, float defaultAlpha, uint32_t req
 			xsize = ilGetInteger(IL_IMAGE_WIDTH);
 			ysize = ilGetInteger(IL_IMAGE_HEIGHT);
 
-			ITexMemPool::texMemPool->FreeRaw(GetRawMem(), curMemSize);
-			memIdx = ITexMemPool::texMemPool->AllocIdxRaw(GetMemSize());
+			ITexMemPool::texMemPool->Free(GetRawMem(), curMemSize);
+			memIdx = ITexMemPool::texMemPool->AllocIdx(GetMemSize());
 
 			for (const ILubyte* imgData = ilGetData(); imgData != nullptr; imgData = nullptr) {
 				std::memset(GetRawMem(), 0xFF   , GetMemSize());
@@ -1414,6 +1629,10 @@ bool CBitmap::Load(std::string const& filename, float defaultAlpha, uint32_t req
 		return false;
 	}
 
+	// store the pixels before the alpha replacement, which depends on the caller
+	if (!cacheFileName.empty())
+		SaveDecodeCacheEntry(*this, cacheFileName, srcHash, hasAlpha);
+
 	if (!hasAlpha || forceReplaceAlpha)
 		ReplaceAlpha(defaultAlpha);
 
@@ -1446,7 +1665,7 @@ bool CBitmap::LoadGrayscale(const std::string& filename)
 	}
 
 	{
-		std::scoped_lock lck(ITexMemPool::texMemPool->GetMutex());
+		std::scoped_lock lck(ilMutex);
 
 		ilOriginFunc(IL_ORIGIN_UPPER_LEFT);
 		ilEnable(IL_ORIGIN_SET);
@@ -1465,8 +1684,8 @@ bool CBitmap::LoadGrayscale(const std::string& filename)
 		xsize = ilGetInteger(IL_IMAGE_WIDTH);
 		ysize = ilGetInteger(IL_IMAGE_HEIGHT);
 
-		ITexMemPool::texMemPool->FreeRaw(GetRawMem(), curMemSize);
-		memIdx = ITexMemPool::texMemPool->AllocIdxRaw(GetMemSize());
+		ITexMemPool::texMemPool->Free(GetRawMem(), curMemSize);
+		memIdx = ITexMemPool::texMemPool->AllocIdx(GetMemSize());
 
 		for (const ILubyte* imgData = ilGetData(); imgData != nullptr; imgData = nullptr) {
 			std::memset(GetRawMem(), 0xFF, GetMemSize());
@@ -1522,11 +1741,10 @@ bool CBitmap::Save(const std::string& filename, bool dontSaveAlpha, bool logged,
 	if (GetMemSize() == 0)
 		return false;
 
-	// operator= acquires ITexMemPool's mutex internally
 	CBitmap flippedCopy = *this;
 	flippedCopy.ReverseYAxis();
 
-	std::unique_lock lck(ITexMemPool::texMemPool->GetMutex());
+	std::unique_lock lck(ilMutex);
 
 	// clear any previous errors
 	while (ilGetError() != IL_NO_ERROR);
@@ -1588,7 +1806,7 @@ bool CBitmap::Save(const std::string& filename, bool dontSaveAlpha, bool logged,
 	ilDeleteImages(1, &imageID);
 	ilDisable(IL_ORIGIN_SET);
 
-	lck.unlock(); //unlock explicitly because Free(flippedCopy) is locking the same mutex
+	lck.unlock();
 
 	return success;
 }
@@ -1635,7 +1853,7 @@ bool CBitmap::SaveFloat(std::string const& filename) const
 	if (GetMemSize() == 0 || channels != 1 || dataType != IL_FLOAT)
 		return false;
 
-	std::scoped_lock lck(ITexMemPool::texMemPool->GetMutex());
+	std::scoped_lock lck(ilMutex);
 
 	using ConvertType = uint16_t;
 	constexpr ConvertType ConvertTypeMAX = std::numeric_limits<ConvertType>::max();
@@ -1644,7 +1862,7 @@ bool CBitmap::SaveFloat(std::string const& filename) const
 	// seems IL_ORIGIN_SET only works in ilLoad and not in ilTexImage nor in ilSaveImage
 	// so we need to flip the image ourselves
 	const auto* f32b = reinterpret_cast<const float*>(GetRawMem());
-	      auto* ctb  = reinterpret_cast<ConvertType*>(ITexMemPool::texMemPool->AllocRaw(channels * xsize * ysize * sizeof(ConvertType)));
+	      auto* ctb  = reinterpret_cast<ConvertType*>(ITexMemPool::texMemPool->Alloc(channels * xsize * ysize * sizeof(ConvertType)));
 
 	const auto* f32e = f32b + channels * xsize * ysize;
 	const auto* f32mem = f32b;
@@ -1672,7 +1890,7 @@ bool CBitmap::SaveFloat(std::string const& filename) const
 	ilTexImage(xsize, ysize, 1, channels, IL_LUMINANCE, ConvertTypeDevIL, ctb);
 	assert(ilGetError() == IL_NO_ERROR);
 
-	ITexMemPool::texMemPool->FreeRaw(reinterpret_cast<uint8_t*>(ctb), channels * xsize * ysize * sizeof(ConvertType));
+	ITexMemPool::texMemPool->Free(reinterpret_cast<uint8_t*>(ctb), channels * xsize * ysize * sizeof(ConvertType));
 
 	const std::string fsImageExt = FileSystem::GetExtension(filename);
 	const std::string fsFullPath = dataDirsAccess.LocateFile(filename, FileQueryFlags::WRITE);
@@ -42,6 +42,7 @@ public:
 
 	static bool CanBeKilled();
 	static void InitPool(size_t size);
+	static void InitDecodeCache(bool enable, size_t maxSize);
 	static void KillPool();
 
 	void Alloc(int w, int h, int c, uint32_t glType);
@@ -0,0 +1,220 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "SkylineAtlasAlloc.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <bit>
+
+#include "System/Misc/TracyDefs.h"
+
+inline bool CSkylineAtlasAlloc::CompareTex(const SAtlasEntry* tex1, const SAtlasEntry* tex2)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	// sort by large to small
+
+	if (tex1->size.y > tex2->size.y) return true;
+	if (tex2->size.y > tex1->size.y) return false;
+
+	if (tex1->size.x > tex2->size.x) return true;
+	if (tex2->size.x > tex1->size.x) return false;
+
+	// silly but will help stabilizing the placement on reload
+	if (tex1->name > tex2->name) return true;
+	if (tex2->name > tex1->name) return false;
+
+	return false;
+}
+
+int CSkylineAtlasAlloc::FitSegment(int segIdx, int rectWidth, int rectHeight) const
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	if ((skyline[segIdx].x + rectWidth) > atlasSize.x)
+		return -1;
+
+	int y = skyline[segIdx].y;
+
+	// the rectangle rests on the highest segment it spans
+	for (int i = segIdx, widthLeft = rectWidth; widthLeft > 0; ++i) {
+		y = std::max(y, skyline[i].y);
+
+		if ((y + rectHeight) > atlasSize.y)
+			return -1;
+
+		widthLeft -= skyline[i].width;
+	}
+
+	return y;
+}
+
+
+int CSkylineAtlasAlloc::FindSegment(int rectWidth, int rectHeight, int& bestX, int& bestY) const
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	int bestIdx = -1;
+	int bestTop = std::numeric_limits<int>::max();
+
+	for (int i = 0, n = skyline.size(); i < n; ++i) {
+		const int y = FitSegment(i, rectWidth, rectHeight);
+
+		if (y < 0)
+			continue;
+
+		// lowest top edge wins, ties go to the leftmost (first) segment
+		if ((y + rectHeight) >= bestTop)
+			continue;
+
+		bestIdx = i;
+		bestTop = y + rectHeight;
+		bestX = skyline[i].x;
+		bestY = y;
+	}
+
+	return bestIdx;
+}
+
+
+void CSkylineAtlasAlloc::AddSegment(int segIdx, int x, int y, int rectWidth, int rectHeight)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	skyline.insert(skyline.begin() + segIdx, Segment{x, y + rectHeight, rectWidth});
+
+	// cut away the parts of the following segments now covered by the rectangle
+	for (size_t i = segIdx + 1; i < skyline.size(); ) {
+		const Segment& prev = skyline[i - 1];
+		Segment& cur = skyline[i];
+
+		const int overlap = (prev.x + prev.width) - cur.x;
+
+		if (overlap <= 0)
+			break;
+
+		cur.x += overlap;
+		cur.width -= overlap;
+
+		if (cur.width > 0)
+			break;
+
+		skyline.erase(skyline.begin() + i);
+	}
+
+	// merge neighbours of equal height
+	for (size_t i = 0; (i + 1) < skyline.size(); ) {
+		if (skyline[i].y != skyline[i + 1].y) {
+			++i;
+			continue;
+		}
+
+		skyline[i].width += skyline[i + 1].width;
+		skyline.erase(skyline.begin() + i + 1);
+	}
+}
+
+
+bool CSkylineAtlasAlloc::PackEntries(const std::vector<SAtlasEntry*>& memtextures, int padding, int2& usedSize)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	bool success = true;
+
+	skyline.clear();
+	skyline.push_back(Segment{0, 0, atlasSize.x});
+
+	usedSize = int2(0, 0);
+
+	for (auto& curtex: memtextures) {
+		const int rectWidth  = curtex->size.x + padding;
+		const int rectHeight = curtex->size.y + padding;
+
+		int x = 0;
+		int y = 0;
+
+		const int segIdx = FindSegment(rectWidth, rectHeight, x, y);
+
+		if (segIdx < 0) {
+			curtex->texCoords = float4();
+			success = false;
+			continue;
+		}
+
+		AddSegment(segIdx, x, y, rectWidth, rectHeight);
+
+		curtex->texCoords.x1 = x;
+		curtex->texCoords.y1 = y;
+		curtex->texCoords.x2 = x + curtex->size.x - 1;
+		curtex->texCoords.y2 = y + curtex->size.y - 1;
+
+		usedSize.x = std::max(usedSize.x, x + rectWidth);
+		usedSize.y = std::max(usedSize.y, y + rectHeight);
+	}
+
+	return success;
+}
+
+
+bool CSkylineAtlasAlloc::Allocate()
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	std::vector<SAtlasEntry*> memtextures;
+	memtextures.reserve(entries.size());
+
+	std::set<std::string> sortedNames;
+	for (auto& entry : entries) {
+		sortedNames.insert(entry.first);
+	}
+
+	for (auto& name : sortedNames) {
+		memtextures.push_back(&entries[name]);
+	}
+
+	std::stable_sort(memtextures.begin(), memtextures.end(), CSkylineAtlasAlloc::CompareTex);
+
+	const int padding = 1 << GetNumTexLevels();
+
+	int minWidth = 32;
+
+	for (const SAtlasEntry* curtex: memtextures) {
+		minWidth = std::max(minWidth, curtex->size.x + padding);
+	}
+
+	int bestWidth = maxsize.x;
+	int64_t bestArea = std::numeric_limits<int64_t>::max();
+	int2 usedSize;
+
+	// packing is cheap compared to the upload, so try every power-of-two width
+	// with unbounded height and keep the one that wastes the least area
+	for (int width = std::bit_ceil<uint32_t>(minWidth); ; width *= 2) {
+		atlasSize = { std::min(width, maxsize.x), maxsize.y };
+
+		if (PackEntries(memtextures, padding, usedSize)) {
+			const int64_t usedArea = int64_t(usedSize.x) * usedSize.y;
+
+			// on equal area keep the narrower one
+			if (usedArea < bestArea) {
+				bestArea = usedArea;
+				bestWidth = atlasSize.x;
+			}
+		}
+
+		if (atlasSize.x >= maxsize.x)
+			break;
+	}
+
+	atlasSize = { bestWidth, maxsize.y };
+
+	const bool success = PackEntries(memtextures, padding, usedSize);
+
+	atlasSize = usedSize;
+
+	return success;
+}
+
+int CSkylineAtlasAlloc::GetNumTexLevels() const
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	return std::min(
+		std::bit_width(static_cast<uint32_t>(GetMinDim())),
+		numLevels
+	);
+}
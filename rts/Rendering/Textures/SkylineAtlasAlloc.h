@@ -0,0 +1,45 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef SKYLINE_ATLAS_ALLOC_H
+#define SKYLINE_ATLAS_ALLOC_H
+
+#include <vector>
+
+#include "IAtlasAllocator.h"
+
+
+// bottom-left skyline packer: keeps the upper contour of the placed rectangles
+// and puts every texture where its top edge ends up lowest, which fills the
+// gaps next to tall textures that the row-based allocators leave empty
+class CSkylineAtlasAlloc : public IAtlasAllocator
+{
+public:
+	CSkylineAtlasAlloc() {
+		atlasSize = { 32, 32 };
+		numLevels = 1;
+	}
+
+	bool Allocate() override;
+	int GetNumTexLevels() const override;
+
+private:
+	struct Segment {
+		int x;
+		int y;
+		int width;
+	};
+
+private:
+	bool PackEntries(const std::vector<SAtlasEntry*>& memtextures, int padding, int2& usedSize);
+
+	int FindSegment(int rectWidth, int rectHeight, int& bestX, int& bestY) const;
+	int FitSegment(int segIdx, int rectWidth, int rectHeight) const;
+	void AddSegment(int segIdx, int x, int y, int rectWidth, int rectHeight);
+
+	static bool CompareTex(const SAtlasEntry* tex1, const SAtlasEntry* tex2);
+
+private:
+	std::vector<Segment> skyline;
+};
+
+#endif // SKYLINE_ATLAS_ALLOC_H
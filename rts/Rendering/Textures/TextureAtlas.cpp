@@ -7,6 +7,7 @@
 #include "LegacyAtlasAlloc.h"
 #include "QuadtreeAtlasAlloc.h"
 #include "RowAtlasAlloc.h"
+#include "SkylineAtlasAlloc.h"
 #include "Rendering/GlobalRendering.h"
 #include "Rendering/GL/myGL.h"
 #include "Rendering/GL/PBO.h"
@@ -16,6 +17,7 @@
 #include "System/Exceptions.h"
 #include "System/SafeUtil.h"
 #include "System/UnorderedSet.hpp"
+#include "System/Threading/ThreadPool.h"
 
 #include <cstring>
 
@@ -65,6 +67,7 @@ void CTextureAtlas::ReinitAllocator()
 		case ATLAS_ALLOC_LEGACY:   { atlasAllocator = new   CLegacyAtlasAlloc(); } break;
 		case ATLAS_ALLOC_QUADTREE: { atlasAllocator = new CQuadtreeAtlasAlloc(); } break;
 		case ATLAS_ALLOC_ROW:      { atlasAllocator = new      CRowAtlasAlloc(); } break;
+		case ATLAS_ALLOC_SKYLINE:  { atlasAllocator = new  CSkylineAtlasAlloc(); } break;
 		default:                   {                              assert(false); } break;
 	}
 
@@ -185,29 +188,41 @@ bool CTextureAtlas::CreateTexture()
 	unsigned char* data = reinterpret_cast<unsigned char*>(pbo.MapBuffer(GL_WRITE_ONLY));
 
 	if (data != nullptr) {
-		// make spacing between textures black transparent to avoid ugly lines with linear filtering
-		std::memset(data, 0, atlasSize.x * atlasSize.y * 4);
+		std::vector<int2> texPositions(memTextures.size());
+
+		// entry lookups touch the allocator's and our own hash-maps, keep them serial
+		for (size_t i = 0; i < memTextures.size(); ++i) {
+			const MemTex& memTex = memTextures[i];
 
-		for (const MemTex& memTex: memTextures) {
 			const float4 texCoords = atlasAllocator->GetTexCoords(memTex.names[0]);
 			const float4 absCoords = atlasAllocator->GetEntry(memTex.names[0]);
 
-			const int xpos = absCoords.x;
-			const int ypos = absCoords.y;
+			texPositions[i] = int2(absCoords.x, absCoords.y);
 
 			AtlasedTexture tex(texCoords);
 
 			for (const auto& name: memTex.names) {
 				textures[name] = std::move(tex); //make sure textures[name] gets only its guts replaced, so all pointers remain valid
 			}
+		}
+
+		// make spacing between textures black transparent to avoid ugly lines with linear filtering
+		for_mt_chunk(0, atlasSize.y, [&](int y) {
+			std::memset(data + size_t(y) * atlasSize.x * 4, 0, atlasSize.x * 4);
+		}, 64);
+
+		// entries never overlap, so every texture can be copied by its own thread
+		for_mt(0, static_cast<int>(memTextures.size()), [&](int i) {
+			const MemTex& memTex = memTextures[i];
+			const int2 texPos = texPositions[i];
 
 			for (int y = 0; y < memTex.ysize; ++y) {
-				int* dst = ((int*)           data  ) + xpos + (ypos + y) * atlasSize.x;
-				int* src = ((int*)memTex.mem.data()) +        (       y) * memTex.xsize;
+				int* dst = ((int*)           data  ) + texPos.x + (texPos.y + y) * atlasSize.x;
+				int* src = ((int*)memTex.mem.data()) +            (           y) * memTex.xsize;
 
 				memcpy(dst, src, memTex.xsize * 4);
 			}
-		}
+		});
 
 		if (debug) {
 			CBitmap tex(data, atlasSize.x, atlasSize.y);
@@ -66,6 +66,7 @@ public:
 		ATLAS_ALLOC_LEGACY   = 0,
 		ATLAS_ALLOC_QUADTREE = 1,
 		ATLAS_ALLOC_ROW      = 2,
+		ATLAS_ALLOC_SKYLINE  = 3,
 	};
 
 public:
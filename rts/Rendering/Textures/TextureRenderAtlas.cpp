@@ -5,6 +5,7 @@
 #include "LegacyAtlasAlloc.h"
 #include "QuadtreeAtlasAlloc.h"
 #include "RowAtlasAlloc.h"
+#include "SkylineAtlasAlloc.h"
 
 #include "Rendering/GlobalRendering.h"
 #include "Rendering/GL/myGL.h"
@@ -71,6 +72,7 @@ CTextureRenderAtlas::CTextureRenderAtlas(
 		case CTextureAtlas::ATLAS_ALLOC_LEGACY:   { atlasAllocator = std::make_unique<  CLegacyAtlasAlloc>(); } break;
 		case CTextureAtlas::ATLAS_ALLOC_QUADTREE: { atlasAllocator = std::make_unique<CQuadtreeAtlasAlloc>(); } break;
 		case CTextureAtlas::ATLAS_ALLOC_ROW:      { atlasAllocator = std::make_unique<     CRowAtlasAlloc>(); } break;
+		case CTextureAtlas::ATLAS_ALLOC_SKYLINE:  { atlasAllocator = std::make_unique< CSkylineAtlasAlloc>(); } break;
 		default:                                  {                                            assert(false); } break;
 	}
 
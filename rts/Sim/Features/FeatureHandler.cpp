@@ -281,6 +281,25 @@ void CFeatureHandler::TerrainChanged(int x1, int y1, int x2, int y2)
 
 	for (const int qi: *qfQuery.quads) {
 		for (CFeature* f: quadField.GetQuad(qi).features) {
+			if (f->inUpdateQue)
+				continue;
+
+			// quads are much coarser than most terrain changes; leave asleep
+			// any feature whose footprint lies outside the changed rectangle
+			// (which is padded by a square since heights are interpolated)
+			const float r = f->radius + SQUARE_SIZE;
+
+			if ((f->pos.x + r) < mins.x || (f->pos.x - r) > maxs.x)
+				continue;
+			if ((f->pos.z + r) < mins.z || (f->pos.z - r) > maxs.z)
+				continue;
+
+			// heightmap has already been updated; an upright feature still
+			// resting exactly on the ground would not move, so needs no wake-up
+			// (others are aligned to the ground normal, which may have changed)
+			if (f->def->upright && f->pos.y == CGround::GetHeightReal(f->pos.x, f->pos.z))
+				continue;
+
 			// put this feature back in the update-queue
 			SetFeatureUpdateable(f);
 		}
@@ -6,6 +6,7 @@
 #include "InterceptHandler.h"
 
 #include "Map/Ground.h"
+#include "Map/ReadMap.h"
 #include "Sim/Misc/GlobalSynced.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "Sim/Weapons/Weapon.h"
@@ -15,6 +16,7 @@
 #include "System/EventHandler.h"
 #include "System/float3.h"
 #include "System/SpringMath.h"
+#include "System/Threading/ThreadPool.h"
 #include "System/creg/STL_Deque.h"
 
 #include "System/Misc/TracyDefs.h"
@@ -23,98 +25,143 @@
 CR_BIND_DERIVED(CInterceptHandler, CObject, )
 CR_REG_METADATA(CInterceptHandler, (
 	CR_MEMBER(interceptors),
-	CR_MEMBER(interceptables)
+	CR_MEMBER(interceptables),
+
+	CR_IGNORED(interceptorGrid),
+	CR_IGNORED(interceptMatches),
+	CR_IGNORED(interceptPairs)
 ))
 
 CInterceptHandler interceptHandler;
 
 
-
 void CInterceptHandler::Update(bool forced) {
 	RECOIL_DETAILED_TRACY_ZONE;
 	if (((gs->frameNum % UNIT_SLOWUPDATE_RATE) != 0) && !forced)
 		return;
 
-	for (CWeapon* w: interceptors) {
-		const WeaponDef* wDef = w->weaponDef;
-		const CUnit* wOwner = w->owner;
-
-		assert(wDef->interceptor || wDef->isShield);
-
-		for (CWeaponProjectile* p: interceptables) {
-			if (!p->CanBeInterceptedBy(wDef))
-				continue;
-			if (w->HasIncomingProjectile(p->id))
-				continue;
-
-			const int pAllyTeam = p->GetAllyteamID();
-
-			if (teamHandler.IsValidAllyTeam(pAllyTeam) && teamHandler.Ally(wOwner->allyteam, pAllyTeam))
-				continue;
-
-			// note: will be called every Update so long as gadget does not return true
-			if (!eventHandler.AllowWeaponInterceptTarget(wOwner, w, p))
-				continue;
-
-			// there are four cases when an interceptor <w> should fire at a projectile <p>:
-			//     1. p's target position inside w's interception circle (w's owner can move!)
-			//     2. p's current position inside w's interception circle
-			//     3. p's projected impact position inside w's interception circle
-			//     4. p's trajectory intersects w's interception circle
-			//
-			// these checks all need to be evaluated periodically, not just
-			// when a projectile is created and handed to AddInterceptTarget
-			const float weaponDist = w->aimFromPos.distance(p->pos);
-			const float impactDist = CGround::LineGroundCol(p->pos, p->pos + p->dir * weaponDist);
-
-			const float3& pImpactPos = p->pos + p->dir * impactDist;
-			const float3& pTargetPos = p->GetTargetPos();
-			const float3  pWeaponVec = p->pos - w->aimFromPos;
-
-			if (w->aimFromPos.SqDistance2D(pTargetPos) < Square(wDef->coverageRange)) {
-				w->AddDeathDependence(p, DEPENDENCE_INTERCEPT);
-				w->AddIncomingProjectile(p->id);
-				continue; // 1
-			}
-
-			if (false /*wDef->noFlyThroughIntercept*/) {
-				// <w> is just a static interceptor and fires only at projectiles
-				// TARGETED within its current interception area; any projectiles
-				// CROSSING its interception area aren't targeted
-				//XXX implement in lua?
-				continue;
-			}
-
-			if (pWeaponVec.SqLength2D() < Square(wDef->coverageRange)) {
-				w->AddDeathDependence(p, DEPENDENCE_INTERCEPT);
-				w->AddIncomingProjectile(p->id);
-				continue; // 2
-			}
-
-			if (w->aimFromPos.SqDistance2D(pImpactPos) < Square(wDef->coverageRange)) {
-				const float3 pTargetDir = (pTargetPos - p->pos).SafeNormalize();
-				const float3 pImpactDir = (pImpactPos - p->pos).SafeNormalize();
-
-				// the projected impact position can briefly shift into the covered
-				// area during transition from vertical to horizontal flight, so we
-				// perform an extra test (NOTE: assumes non-parabolic trajectory)
-				if (pTargetDir.dot(pImpactDir) >= 0.999f) {
-					w->AddDeathDependence(p, DEPENDENCE_INTERCEPT);
-					w->AddIncomingProjectile(p->id);
-					continue; // 3
-				}
-			}
-
-			const float3 pMinSepPos = p->pos + p->dir * std::clamp(-(pWeaponVec.dot(p->dir)), 0.0f, impactDist);
-			const float3 pMinSepVec = w->aimFromPos - pMinSepPos;
-
-			if (pMinSepVec.SqLength() < Square(wDef->coverageRange)) {
-				w->AddDeathDependence(p, DEPENDENCE_INTERCEPT);
-				w->AddIncomingProjectile(p->id);
-				continue; // 4
-			}
+	if (interceptors.empty() || interceptables.empty())
+		return;
+
+	UpdateInterceptorGrid();
+
+	interceptMatches.resize(interceptables.size());
+
+	// matching is read-only, so each interceptable can be processed in parallel
+	for_mt(0, interceptables.size(), [this](const int i) {
+		const CWeaponProjectile* p = interceptables[i];
+
+		std::vector<int>& matches = interceptMatches[i];
+
+		// every case tested by CanIntercept implies that the coverage circle
+		// contains either the target position or some point on the 2D ray;
+		// start one elmo behind the projectile to cover the no-ground-collision
+		// fallback positions
+		interceptorGrid.GetCandidates(p->GetTargetPos(), p->pos - p->dir, p->dir * XZVector, matches);
+
+		const auto pred = [&](int j) { return (!CanIntercept(interceptors[j], p)); };
+		const auto iter = std::remove_if(matches.begin(), matches.end(), pred);
+
+		matches.erase(iter, matches.end());
+	});
+
+	interceptPairs.clear();
+
+	for (size_t i = 0, n = interceptables.size(); i < n; i++) {
+		for (const int j: interceptMatches[i]) {
+			interceptPairs.emplace_back(j, i);
 		}
 	}
+
+	// assign in the same (interceptor-major) order as a serial sweep would
+	std::sort(interceptPairs.begin(), interceptPairs.end());
+
+	for (const auto& pair: interceptPairs) {
+		CWeapon* w = interceptors[pair.first];
+		CWeaponProjectile* p = interceptables[pair.second];
+
+		// note: will be called every Update so long as gadget does not return true
+		if (!eventHandler.AllowWeaponInterceptTarget(w->owner, w, p))
+			continue;
+
+		w->AddDeathDependence(p, DEPENDENCE_INTERCEPT);
+		w->AddIncomingProjectile(p->id);
+	}
+}
+
+
+void CInterceptHandler::UpdateInterceptorGrid()
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	interceptorGrid.Reset(mapDims.mapx * SQUARE_SIZE, mapDims.mapy * SQUARE_SIZE);
+
+	for (size_t i = 0, n = interceptors.size(); i < n; i++) {
+		interceptorGrid.AddInterceptor(i, interceptors[i]->aimFromPos, interceptors[i]->weaponDef->coverageRange);
+	}
+}
+
+
+bool CInterceptHandler::CanIntercept(const CWeapon* w, const CWeaponProjectile* p) const
+{
+	const WeaponDef* wDef = w->weaponDef;
+	const CUnit* wOwner = w->owner;
+
+	assert(wDef->interceptor || wDef->isShield);
+
+	if (!p->CanBeInterceptedBy(wDef))
+		return false;
+	if (w->HasIncomingProjectile(p->id))
+		return false;
+
+	const int pAllyTeam = p->GetAllyteamID();
+
+	if (teamHandler.IsValidAllyTeam(pAllyTeam) && teamHandler.Ally(wOwner->allyteam, pAllyTeam))
+		return false;
+
+	// there are four cases when an interceptor <w> should fire at a projectile <p>:
+	//     1. p's target position inside w's interception circle (w's owner can move!)
+	//     2. p's current position inside w's interception circle
+	//     3. p's projected impact position inside w's interception circle
+	//     4. p's trajectory intersects w's interception circle
+	//
+	// these checks all need to be evaluated periodically, not just
+	// when a projectile is created and handed to AddInterceptTarget
+	const float weaponDist = w->aimFromPos.distance(p->pos);
+	const float impactDist = CGround::LineGroundCol(p->pos, p->pos + p->dir * weaponDist);
+
+	const float3& pImpactPos = p->pos + p->dir * impactDist;
+	const float3& pTargetPos = p->GetTargetPos();
+	const float3  pWeaponVec = p->pos - w->aimFromPos;
+
+	if (w->aimFromPos.SqDistance2D(pTargetPos) < Square(wDef->coverageRange))
+		return true; // 1
+
+	if (false /*wDef->noFlyThroughIntercept*/) {
+		// <w> is just a static interceptor and fires only at projectiles
+		// TARGETED within its current interception area; any projectiles
+		// CROSSING its interception area aren't targeted
+		//XXX implement in lua?
+		return false;
+	}
+
+	if (pWeaponVec.SqLength2D() < Square(wDef->coverageRange))
+		return true; // 2
+
+	if (w->aimFromPos.SqDistance2D(pImpactPos) < Square(wDef->coverageRange)) {
+		const float3 pTargetDir = (pTargetPos - p->pos).SafeNormalize();
+		const float3 pImpactDir = (pImpactPos - p->pos).SafeNormalize();
+
+		// the projected impact position can briefly shift into the covered
+		// area during transition from vertical to horizontal flight, so we
+		// perform an extra test (NOTE: assumes non-parabolic trajectory)
+		if (pTargetDir.dot(pImpactDir) >= 0.999f)
+			return true; // 3
+	}
+
+	const float3 pMinSepPos = p->pos + p->dir * std::clamp(-(pWeaponVec.dot(p->dir)), 0.0f, impactDist);
+	const float3 pMinSepVec = w->aimFromPos - pMinSepPos;
+
+	return (pMinSepVec.SqLength() < Square(wDef->coverageRange)); // 4
 }
 
 
@@ -4,6 +4,8 @@
 #define INTERCEPT_HANDLER_H
 
 #include <deque>
+#include <vector>
+#include "InterceptorGrid.h"
 #include "System/Misc/NonCopyable.h"
 #include "System/Object.h"
 
@@ -26,9 +28,22 @@ public:
 
 	void DependentDied(CObject* o);
 
+private:
+	void UpdateInterceptorGrid();
+
+	bool CanIntercept(const CWeapon* w, const CWeaponProjectile* p) const;
+
 private:
 	std::deque<CWeapon*> interceptors;
 	std::deque<CWeaponProjectile*> interceptables;
+
+	// indices into <interceptors>, rebuilt on each Update
+	CInterceptorGrid interceptorGrid;
+
+	// per-interceptable matched interceptor indices, then all matched
+	// (interceptor, interceptable) pairs in deterministic order
+	std::vector< std::vector<int> > interceptMatches;
+	std::vector< std::pair<int, int> > interceptPairs;
 };
 
 extern CInterceptHandler interceptHandler;
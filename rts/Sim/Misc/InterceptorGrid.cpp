@@ -0,0 +1,137 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "InterceptorGrid.h"
+
+#include "System/float3.h"
+#include "System/SpringMath.h"
+
+#include "System/Misc/TracyDefs.h"
+
+
+void CInterceptorGrid::Reset(float mapSizeX, float mapSizeZ)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	gridSizeX = std::max(1, static_cast<int>(std::ceil(mapSizeX / CELL_SIZE)));
+	gridSizeZ = std::max(1, static_cast<int>(std::ceil(mapSizeZ / CELL_SIZE)));
+
+	cells.resize(gridSizeX * gridSizeZ);
+	overflowInterceptors.clear();
+
+	for (auto& cell: cells) {
+		cell.clear();
+	}
+}
+
+void CInterceptorGrid::AddInterceptor(int index, const float3& pos, float radius)
+{
+	const float gridExtentX = gridSizeX * CELL_SIZE;
+	const float gridExtentZ = gridSizeZ * CELL_SIZE;
+
+	if ((pos.x - radius) < 0.0f || (pos.x + radius) > gridExtentX || (pos.z - radius) < 0.0f || (pos.z + radius) > gridExtentZ) {
+		overflowInterceptors.push_back(index);
+		return;
+	}
+
+	const int x1 = std::clamp(static_cast<int>((pos.x - radius) / CELL_SIZE), 0, gridSizeX - 1);
+	const int x2 = std::clamp(static_cast<int>((pos.x + radius) / CELL_SIZE), 0, gridSizeX - 1);
+	const int z1 = std::clamp(static_cast<int>((pos.z - radius) / CELL_SIZE), 0, gridSizeZ - 1);
+	const int z2 = std::clamp(static_cast<int>((pos.z + radius) / CELL_SIZE), 0, gridSizeZ - 1);
+
+	for (int z = z1; z <= z2; z++) {
+		for (int x = x1; x <= x2; x++) {
+			cells[z * gridSizeX + x].push_back(index);
+		}
+	}
+}
+
+
+void CInterceptorGrid::GetCandidates(const float3& targetPos, const float3& rayPos, const float3& rayDir, std::vector<int>& candidates) const
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	const float gridExtentX = gridSizeX * CELL_SIZE;
+	const float gridExtentZ = gridSizeZ * CELL_SIZE;
+
+	const auto AddCell = [&](int x, int z) {
+		const std::vector<int>& cell = cells[std::clamp(z, 0, gridSizeZ - 1) * gridSizeX + std::clamp(x, 0, gridSizeX - 1)];
+		candidates.insert(candidates.end(), cell.begin(), cell.end());
+	};
+	const auto InGrid = [&](const float3& pos) {
+		return (pos.x >= 0.0f && pos.x <= gridExtentX && pos.z >= 0.0f && pos.z <= gridExtentZ);
+	};
+	const auto Finish = [&]() {
+		std::sort(candidates.begin(), candidates.end());
+		candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+	};
+
+	candidates.assign(overflowInterceptors.begin(), overflowInterceptors.end());
+
+	// circles of bucketed interceptors lie entirely within the grid, so they
+	// can only contain points inside it
+	if (InGrid(targetPos))
+		AddCell(targetPos.x / CELL_SIZE, targetPos.z / CELL_SIZE);
+
+	// clip the ray against the grid, then walk all cells it passes through
+	float tMin = 0.0f;
+	float tMax = std::numeric_limits<float>::max();
+
+	for (int a = 0; a < 3; a += 2) {
+		const float size = (a == 0)? gridExtentX: gridExtentZ;
+
+		if (rayDir[a] == 0.0f) {
+			if (rayPos[a] < 0.0f || rayPos[a] > size) {
+				Finish();
+				return;
+			}
+
+			continue;
+		}
+
+		const float t0 = (0.0f - rayPos[a]) / rayDir[a];
+		const float t1 = (size - rayPos[a]) / rayDir[a];
+
+		tMin = std::max(tMin, std::min(t0, t1));
+		tMax = std::min(tMax, std::max(t0, t1));
+	}
+
+	if (tMin > tMax) {
+		Finish();
+		return;
+	}
+
+	const float3 entryPos = rayPos + rayDir * tMin;
+
+	int cellX = std::clamp(static_cast<int>(entryPos.x / CELL_SIZE), 0, gridSizeX - 1);
+	int cellZ = std::clamp(static_cast<int>(entryPos.z / CELL_SIZE), 0, gridSizeZ - 1);
+
+	const int stepX = (rayDir.x > 0.0f) - (rayDir.x < 0.0f);
+	const int stepZ = (rayDir.z > 0.0f) - (rayDir.z < 0.0f);
+
+	constexpr float tInf = std::numeric_limits<float>::max();
+
+	const float tDeltaX = (stepX != 0)? (CELL_SIZE / math::fabs(rayDir.x)): tInf;
+	const float tDeltaZ = (stepZ != 0)? (CELL_SIZE / math::fabs(rayDir.z)): tInf;
+
+	float tNextX = (stepX != 0)? (((cellX + (stepX > 0)) * CELL_SIZE - rayPos.x) / rayDir.x): tInf;
+	float tNextZ = (stepZ != 0)? (((cellZ + (stepZ > 0)) * CELL_SIZE - rayPos.z) / rayDir.z): tInf;
+
+	while (cellX >= 0 && cellX < gridSizeX && cellZ >= 0 && cellZ < gridSizeZ) {
+		AddCell(cellX, cellZ);
+
+		if (std::min(tNextX, tNextZ) >= tMax)
+			break;
+
+		if (tNextX < tNextZ) {
+			tNextX += tDeltaX;
+			cellX += stepX;
+		} else {
+			tNextZ += tDeltaZ;
+			cellZ += stepZ;
+		}
+	}
+
+	Finish();
+}
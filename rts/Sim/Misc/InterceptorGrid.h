@@ -0,0 +1,42 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef INTERCEPTOR_GRID_H
+#define INTERCEPTOR_GRID_H
+
+#include <vector>
+
+#include "Sim/Misc/GlobalConstants.h"
+
+class float3;
+
+/**
+ * Buckets interceptor indices by the grid-cells their 2D coverage circles
+ * overlap, so CInterceptHandler only has to test an interceptable against
+ * the interceptors near its target position and its flight ray.
+ * Circles that extend beyond the map go into an overflow list and become
+ * candidates for every interceptable.
+ */
+class CInterceptorGrid
+{
+public:
+	static constexpr float CELL_SIZE = SQUARE_SIZE * 64.0f;
+
+	void Reset(float mapSizeX, float mapSizeZ);
+	void AddInterceptor(int index, const float3& pos, float radius);
+
+	/**
+	 * Collects (sorted and without duplicates) all interceptors whose circles
+	 * could contain <targetPos> or some point on the 2D ray from <rayPos> in
+	 * direction <rayDir> (y is ignored, need not be normalized).
+	 */
+	void GetCandidates(const float3& targetPos, const float3& rayPos, const float3& rayDir, std::vector<int>& candidates) const;
+
+private:
+	std::vector< std::vector<int> > cells;
+	std::vector<int> overflowInterceptors;
+
+	int gridSizeX = 0;
+	int gridSizeZ = 0;
+};
+
+#endif /* INTERCEPTOR_GRID_H */
@@ -9,6 +9,7 @@
 #include "Sim/Misc/GlobalConstants.h"
 #include "Sim/Misc/TeamHandler.h"
 #include "System/ContainerUtil.h"
+#include "System/ScratchArena.h"
 #include "System/Threading/ThreadPool.h"
 
 #ifndef UNIT_TEST
@@ -967,11 +968,12 @@ bool CQuadField::NoSolidsExact(
 
 
 // optimization specifically for projectile collisions
+template<typename UnitAlloc, typename FeatureAlloc>
 void CQuadField::GetUnitsAndFeaturesColVol(
 	const float3& pos,
 	const float radius,
-	std::vector<CUnit*>& units,
-	std::vector<CFeature*>& features,
+	std::vector<CUnit*, UnitAlloc>& units,
+	std::vector<CFeature*, FeatureAlloc>& features,
 	std::vector<CPlasmaRepulser*>* repulsers
 ) {
 	RECOIL_DETAILED_TRACY_ZONE;
@@ -1034,4 +1036,7 @@ void CQuadField::GetUnitsAndFeaturesColVol(
 		}
 	}
 }
+
+template void CQuadField::GetUnitsAndFeaturesColVol(const float3&, const float, std::vector<CUnit*>&, std::vector<CFeature*>&, std::vector<CPlasmaRepulser*>*);
+template void CQuadField::GetUnitsAndFeaturesColVol(const float3&, const float, spring::scratch_vector<CUnit*>&, spring::scratch_vector<CFeature*>&, std::vector<CPlasmaRepulser*>*);
 #endif // UNIT_TEST
@@ -98,11 +98,13 @@ public:
 	void GetQuadsOnRay(QuadFieldQuery& qfq, const float3& start, const float3& dir, float length);
 	void GetQuadsOnWideRay(QuadFieldQuery& qfq, const float3& start, const float3& dir, float length, float width);
 
+	// instantiated for std::allocator and spring::ScratchAllocator
+	template<typename UnitAlloc, typename FeatureAlloc>
 	void GetUnitsAndFeaturesColVol(
 		const float3& pos,
 		const float radius,
-		std::vector<CUnit*>& units,
-		std::vector<CFeature*>& features,
+		std::vector<CUnit*, UnitAlloc>& units,
+		std::vector<CFeature*, FeatureAlloc>& features,
 		std::vector<CPlasmaRepulser*>* repulsers = nullptr
 	);
 
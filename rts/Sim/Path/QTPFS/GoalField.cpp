@@ -0,0 +1,110 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "GoalField.h"
+#include "NodeLayer.h"
+#include "Node.h"
+#include "SearchQueue.h"
+
+#include "System/Misc/TracyDefs.h"
+
+
+void QTPFS::GoalField::Clear() {
+	edgeOffsets.clear();
+	edgeCosts.clear();
+
+	goalNodeIndex = -1u;
+}
+
+void QTPFS::GoalField::Build(const NodeLayer& nodeLayer, unsigned int goalNodeIdx) {
+	ZoneScoped;
+	Clear();
+
+	const INode* goalNode = nodeLayer.GetPoolNode(goalNodeIdx);
+	const unsigned int numNodes = nodeLayer.GetMaxNodesAlloced();
+
+	goalNodeIndex = goalNodeIdx;
+	regionVersion = nodeLayer.GetRegionGraph().GetVersion();
+
+	// one cost slot per directed edge, laid out like the neighbour lists
+	std::vector<std::uint32_t> edgeSrcNodes;
+
+	edgeOffsets.resize(numNodes + 1, 0);
+
+	for (unsigned int i = 0; i < numNodes; ++i) {
+		const INode* node = nodeLayer.GetPoolNode(i);
+		const bool active = (node->IsLeaf() && !node->NodeDeactivated());
+		const unsigned int numEdges = active? node->GetNeighbours().size(): 0;
+
+		edgeOffsets[i + 1] = edgeOffsets[i] + numEdges;
+		edgeSrcNodes.insert(edgeSrcNodes.end(), numEdges, i);
+	}
+
+	edgeCosts.assign(edgeOffsets[numNodes], std::numeric_limits<float>::infinity());
+
+	const auto getNodeCost = [](const INode* node) {
+		return (node->AllSquaresImpassable()? QTPFS_CLOSED_NODE_COST: node->GetMoveCost());
+	};
+	const auto getNeighbourSlot = [this, &nodeLayer, numNodes](unsigned int fromNodeIdx, unsigned int toNodeIdx) {
+		if (fromNodeIdx >= numNodes)
+			return -1;
+
+		const auto& neighbours = nodeLayer.GetPoolNode(fromNodeIdx)->GetNeighbours();
+		// inactive nodes can keep stale neighbour lists but own no edges
+		const unsigned int numEdges = edgeOffsets[fromNodeIdx + 1] - edgeOffsets[fromNodeIdx];
+
+		for (unsigned int slot = 0; slot < numEdges; ++slot) {
+			if (unsigned(neighbours[slot].nodeId) == toNodeIdx)
+				return int(slot);
+		}
+
+		return -1;
+	};
+
+	SearchPriorityQueue openEdges;
+
+	// the step from the goal node's edge to the target point depends on where
+	// each search's target lies inside it, count it as zero to stay admissible
+	for (const auto& neighbour: goalNode->GetNeighbours()) {
+		const int slot = getNeighbourSlot(neighbour.nodeId, goalNodeIdx);
+
+		if (slot < 0)
+			continue;
+
+		const unsigned int edgeIdx = edgeOffsets[neighbour.nodeId] + slot;
+
+		edgeCosts[edgeIdx] = 0.0f;
+		openEdges.emplace(edgeIdx, edgeCosts[edgeIdx]);
+	}
+
+	// run backwards: an edge (k -> n) at transition-point q is reached from any
+	// edge (j -> k) at q' by crossing k, which costs moveCost(k) * |q' - q|
+	while (!openEdges.empty()) {
+		const SearchQueueNode curEdge = openEdges.top();
+		openEdges.pop();
+
+		if (curEdge.heapPriority > edgeCosts[curEdge.nodeIndex])
+			continue;
+
+		const unsigned int curNodeIdx = edgeSrcNodes[curEdge.nodeIndex];
+		const INode* curNode = nodeLayer.GetPoolNode(curNodeIdx);
+		const float2& curPoint = curNode->GetNeighbours()[curEdge.nodeIndex - edgeOffsets[curNodeIdx]].netpoints[0];
+		const float curNodeCost = getNodeCost(curNode);
+
+		for (const auto& neighbour: curNode->GetNeighbours()) {
+			const int slot = getNeighbourSlot(neighbour.nodeId, curNodeIdx);
+
+			if (slot < 0)
+				continue;
+
+			const unsigned int prvEdgeIdx = edgeOffsets[neighbour.nodeId] + slot;
+			const float2& prvPoint = nodeLayer.GetPoolNode(neighbour.nodeId)->GetNeighbours()[slot].netpoints[0];
+			const float cost = edgeCosts[curEdge.nodeIndex] + curNodeCost * prvPoint.Distance(curPoint);
+
+			if (cost >= edgeCosts[prvEdgeIdx])
+				continue;
+
+			edgeCosts[prvEdgeIdx] = cost;
+			openEdges.emplace(prvEdgeIdx, cost);
+		}
+	}
+}
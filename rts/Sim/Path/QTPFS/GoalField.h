@@ -0,0 +1,71 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef QTPFS_GOALFIELD_H_
+#define QTPFS_GOALFIELD_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace QTPFS {
+	struct NodeLayer;
+
+	// Dijkstra map of one goal node, shared by every search of a large group
+	// moving to the same place. A single backwards search from the goal stores
+	// the remaining cost from every node edge transition-point, using the same
+	// points (netpoints[0]) and node move-costs as PathSearch; the forward
+	// searches of the group use it as heuristic and then walk (nearly) straight
+	// to the goal.
+	//
+	// The costs are exact up to where the goal node is entered; the last leg to
+	// each search's own target point inside that node is counted as zero, which
+	// keeps them a lower bound for every search sharing the field.
+	struct GoalField {
+	public:
+		void Build(const NodeLayer& nodeLayer, unsigned int goalNodeIdx);
+		void Clear();
+
+		// remaining cost after entering the <ngbSlot>'th neighbour of <nodeIdx>
+		// through their shared transition-point; never less than <minCost> (the
+		// straight-line estimate), which is also returned if it is unreachable
+		float GetRemainingCost(unsigned int nodeIdx, unsigned int ngbSlot, float minCost) const {
+			if (nodeIdx + 1 >= edgeOffsets.size())
+				return minCost;
+
+			const unsigned int edgeIdx = edgeOffsets[nodeIdx] + ngbSlot;
+
+			if (edgeIdx >= edgeOffsets[nodeIdx + 1])
+				return minCost;
+			if (edgeCosts[edgeIdx] == std::numeric_limits<float>::infinity())
+				return minCost;
+
+			return std::max(edgeCosts[edgeIdx], minCost);
+		}
+
+		unsigned int GetGoalNodeIndex() const { return goalNodeIndex; }
+		unsigned int GetRegionVersion() const { return regionVersion; }
+
+		void SetLastUsedFrame(int frame) { lastUsedFrame = frame; }
+		int GetLastUsedFrame() const { return lastUsedFrame; }
+
+		std::uint64_t GetMemFootPrint() const {
+			std::uint64_t memFootPrint = sizeof(GoalField);
+			memFootPrint += (edgeOffsets.size() * sizeof(decltype(edgeOffsets)::value_type));
+			memFootPrint += (edgeCosts.size() * sizeof(decltype(edgeCosts)::value_type));
+			return memFootPrint;
+		}
+
+	private:
+		// per pool node, first index into edgeCosts of its neighbour list
+		std::vector<std::uint32_t> edgeOffsets;
+		std::vector<float> edgeCosts;
+
+		unsigned int goalNodeIndex = -1u;
+		unsigned int regionVersion = 0;
+
+		int lastUsedFrame = 0;
+	};
+}
+
+#endif
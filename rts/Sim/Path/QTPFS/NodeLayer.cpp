@@ -83,6 +83,7 @@ void QTPFS::NodeLayer::Clear() {
 	RECOIL_DETAILED_TRACY_ZONE;
 	curSpeedMods.clear();
 	curSpeedBins.clear();
+	regionGraph.Clear();
 }
 
 
@@ -14,6 +14,7 @@
 #include "Node.h"
 #include "PathDefines.h"
 #include "PathThreads.h"
+#include "RegionGraph.h"
 
 #include "System/Log/ILog.h"
 #include "System/Rectangle.h"
@@ -141,6 +142,7 @@ namespace QTPFS {
 			}
 
 			memFootPrint += (nodeIndcs.size() * sizeof(decltype(nodeIndcs)::value_type));
+			memFootPrint += regionGraph.GetMemFootPrint();
 			return memFootPrint;
 		}
 
@@ -155,6 +157,13 @@ namespace QTPFS {
 			return numRootNodes;
 		}
 
+		int GetXRootNodes() const { return xRootNodes; }
+		int GetZRootNodes() const { return zRootNodes; }
+		int GetRootNodeSize() const { return rootNodeSize; }
+
+		      RegionGraph& GetRegionGraph()       { return regionGraph; }
+		const RegionGraph& GetRegionGraph() const { return regionGraph; }
+
 		int GetNodelayer() const {
 			return layerNumber;
 		}
@@ -175,6 +184,8 @@ namespace QTPFS {
 		std::vector<SpeedModType> curSpeedMods;
 		std::vector<SpeedBinType> curSpeedBins;
 
+		RegionGraph regionGraph;
+
 public:
 		static constexpr unsigned int NUM_POOL_CHUNKS = sizeof(poolNodes) / sizeof(poolNodes[0]);
 		static constexpr unsigned int POOL_TOTAL_SIZE = (1024 * 1024) / 2;
@@ -37,6 +37,9 @@ static constexpr uint32_t QTPFS_PARTIAL_SHARE_PATH_MAX_SIZE = 32;
 
 static constexpr uint32_t QTPFS_MAP_DAMAGE_SIZE = 16;
 
+// searches whose coarse route crosses fewer regions than this are not restricted to a corridor
+static constexpr uint32_t QTPFS_CORRIDOR_MIN_ROUTE_REGIONS = 4;
+
 // Though there are four quads per level, having nothing is like a 5th state. So 3 bits, not 2, is needed per level.
 static constexpr uint32_t QTPFS_NODE_NUMBER_SHIFT_STEP = 3;
 
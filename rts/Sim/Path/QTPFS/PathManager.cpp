@@ -9,6 +9,8 @@
 #include <cinttypes>
 #include <deque>
 #include <functional>
+#include <random>
+#include <tuple>
 
 #include "System/Threading/ThreadPool.h"
 #include "System/Threading/SpringThreading.h"
@@ -129,6 +131,9 @@ namespace QTPFS {
 
 	unsigned int PathManager::LAYERS_PER_UPDATE;
 	unsigned int PathManager::MAX_TEAM_SEARCHES;
+	unsigned int PathManager::MAX_SEARCHES_PER_FRAME;
+	unsigned int PathManager::MIN_GOAL_FIELD_SEARCHES;
+	unsigned int PathManager::MAX_GOAL_FIELDS;
 }
 
 QTPFS::PathManager::PathManager() {
@@ -189,6 +194,7 @@ QTPFS::PathManager::~PathManager() {
 	nodeLayersMapDamageTrack.mapChangeTrackers.clear();
 	sharedPaths.clear();
 	partialSharedPaths.clear();
+	goalFields.clear();
 
 	// numCurrExecutedSearches.clear();
 	// numPrevExecutedSearches.clear();
@@ -226,6 +232,9 @@ void QTPFS::PathManager::InitStatic() {
 	RECOIL_DETAILED_TRACY_ZONE;
 	LAYERS_PER_UPDATE = std::max(1u, mapInfo->pfs.qtpfs_constants.layersPerUpdate);
 	MAX_TEAM_SEARCHES = std::max(1u, mapInfo->pfs.qtpfs_constants.maxTeamSearches);
+	MAX_SEARCHES_PER_FRAME = mapInfo->pfs.qtpfs_constants.maxSearchesPerFrame;
+	MIN_GOAL_FIELD_SEARCHES = mapInfo->pfs.qtpfs_constants.minGoalFieldSearches;
+	MAX_GOAL_FIELDS = mapInfo->pfs.qtpfs_constants.maxGoalFields;
 
 	// Ensure SharedPathChain is assigned a Pool by EnTT to avoid it happening in an MT section,
 	// which would cause a potential race condition. Failure to do this can cause seemingly random
@@ -261,6 +270,7 @@ void QTPFS::PathManager::Load() {
 	// NOTE: offset *must* start at a non-zero value
 	searchStateOffset = NODE_STATE_OFFSET;
 	numPathRequests   = 0;
+	numSyncedSearches = 0;
 	int maxAllocedNodes   = 0;
 
 	deadPathsToUpdatePerFrame = 1;
@@ -389,6 +399,10 @@ std::uint64_t QTPFS::PathManager::GetMemFootPrint() const {
 	memFootPrint += sharedPaths.size() * sizeof(decltype(sharedPaths)::value_type);
 	memFootPrint += partialSharedPaths.size() * sizeof(decltype(partialSharedPaths)::value_type);
 
+	for (const auto& pair: goalFields) {
+		memFootPrint += pair.second.GetMemFootPrint();
+	}
+
 	memFootPrint += sizeof(nodeLayersMapDamageTrack);
 	memFootPrint += nodeLayersMapDamageTrack.mapChangeTrackers.size()
 					* sizeof(decltype(nodeLayersMapDamageTrack.mapChangeTrackers)::value_type);
@@ -438,6 +452,7 @@ void QTPFS::PathManager::InitNodeLayersThreaded(const SRectangle& rect) {
 		NodeLayer& layer = nodeLayers[layerNum];
 
 		InitNodeLayer(layerNum, rect);
+		layer.GetRegionGraph().Init(layer);
 
 		INode* rootNode = layer.GetPoolNode(0);
 
@@ -457,6 +472,8 @@ void QTPFS::PathManager::InitNodeLayersThreaded(const SRectangle& rect) {
 		std::for_each(rootRects.begin(), rootRects.end(), [this, layerNum, currentThread](auto &rect){
 			UpdateNodeLayer(layerNum, rect, currentThread);
 		});
+
+		layer.GetRegionGraph().Update(layer);
 	});
 
 	// Full map-wide allocations have been made, we shouldn't need that much memory in future.
@@ -616,6 +633,9 @@ void QTPFS::PathManager::UpdateNodeLayer(unsigned int layerNum, const SRectangle
 	updateThreadData[currentThread].InitUpdate(r, *containingNode, *md, currentThread);
 	const bool needTesselation = nodeLayers[layerNum].Update(updateThreadData[currentThread]);
 
+	// passability can change without a re-tesselation, so always refresh the coarse regions
+	nodeLayers[layerNum].GetRegionGraph().MarkDirty(nodeLayers[layerNum], re);
+
 	// process the affected root nodes.
 
 	// LOG("%s: [%d] needTesselation=%d, wantTesselation=%d", __func__, layerNum, (int)needTesselation, (int)wantTesselation);
@@ -638,6 +658,8 @@ void QTPFS::PathManager::UpdateNodeLayer(unsigned int layerNum, const SRectangle
 		#ifndef QTPFS_CONSERVATIVE_NEIGHBOR_CACHE_UPDATES
 		nodeLayers[layerNum].ExecNodeNeighborCacheUpdates(ur, updateThreadData[currentThread]);
 		#endif
+
+		nodeLayer.GetRegionGraph().MarkDirty(nodeLayer, ur);
 	}
 }
 
@@ -718,6 +740,8 @@ void QTPFS::PathManager::Update() {
 			int layerNum = nodeLayerUpdatePriorityOrder[index];
 			int blocksToUpdate = numBlocksToUpdate(layerNum);
 			for (int i = 0; i < blocksToUpdate; ++i) { UpdateNodeLayer(layerNum, rect, curThread); }
+
+			nodeLayers[layerNum].GetRegionGraph().Update(nodeLayers[layerNum]);
 		});
 
 		// Mark all dirty paths so that they can be recalculated
@@ -852,13 +876,69 @@ bool QTPFS::PathManager::InitializeSearch(entt::entity searchEntity) {
 	return search->initialized;
 }
 
+void QTPFS::PathManager::DeferQueuedSearches() {
+	RECOIL_DETAILED_TRACY_ZONE;
+
+	struct DeferCandidate {
+		entt::entity entity;
+		unsigned int deferredFrames;
+		unsigned int syncedSeqNum;
+	};
+
+	static std::vector<DeferCandidate> candidates;
+	candidates.clear();
+
+	auto pathView = registry.view<PathSearch>();
+
+	for (entt::entity entity: pathView) {
+		PathSearch& search = pathView.get<PathSearch>(entity);
+		search.deferred = false;
+
+		// unsynced searches differ between clients, so they must neither count toward
+		// the cap nor be held back by it
+		if (!search.synced || search.initialized)
+			continue;
+
+		if (!registry.all_of<IPath>((entt::entity)search.GetID()))
+			continue;
+
+		candidates.push_back({entity, search.deferredFrames, search.syncedSeqNum});
+	}
+
+	if (candidates.size() <= MAX_SEARCHES_PER_FRAME)
+		return;
+
+	// entity ids and storage order are not synced (unsynced requests share the registry
+	// and make entt recycle ids differently per client), so pick the searches to run this
+	// frame by synced data only; longest-waiting first, then in the order they were queued
+	std::stable_sort(candidates.begin(), candidates.end(), [](const DeferCandidate& a, const DeferCandidate& b) {
+		if (a.deferredFrames != b.deferredFrames)
+			return (a.deferredFrames > b.deferredFrames);
+		return (a.syncedSeqNum < b.syncedSeqNum);
+	});
+
+	for (size_t i = MAX_SEARCHES_PER_FRAME; i < candidates.size(); ++i) {
+		PathSearch& search = pathView.get<PathSearch>(candidates[i].entity);
+		search.deferred = true;
+		search.deferredFrames += 1;
+	}
+}
+
 void QTPFS::PathManager::ReadyQueuedSearches() {
 	RECOIL_DETAILED_TRACY_ZONE;
+
+	if (MAX_SEARCHES_PER_FRAME > 0)
+		DeferQueuedSearches();
+
 	{
 		auto pathView = registry.view<PathSearch>();
 
 		// Go through in reverse order to minimize reshuffling EnTT will do with the grouping.
-		std::for_each(pathView.rbegin(), pathView.rend(), [this](entt::entity entity){
+		std::for_each(pathView.rbegin(), pathView.rend(), [this, &pathView](entt::entity entity){
+			// held back until a later frame; initialized then so it starts from fresh data
+			if (pathView.get<PathSearch>(entity).deferred)
+				return;
+
 			if (InitializeSearch(entity))
 				registry.emplace_or_replace<ProcessPath>(entity);
 		});
@@ -868,18 +948,135 @@ void QTPFS::PathManager::ReadyQueuedSearches() {
 
 		// Any requests that cannot be processed should be removed. We can't do that with the r*
 		// iterators because that will break them.
-		std::for_each(pathView.begin(), pathView.end(), [this](entt::entity entity){
-			if (!registry.all_of<ProcessPath>(entity))
+		std::for_each(pathView.begin(), pathView.end(), [this, &pathView](entt::entity entity){
+			if (!registry.all_of<ProcessPath>(entity) && !pathView.get<PathSearch>(entity).deferred)
 				registry.destroy(entity);
 		});
 	}
 }
 
+void QTPFS::PathManager::AssignGoalFields() {
+	RECOIL_DETAILED_TRACY_ZONE;
+
+	// fields nobody asked for within this many frames are released
+	constexpr int GOAL_FIELD_LIFETIME = GAME_SPEED * 5;
+
+	static spring::unordered_map<std::uint64_t, unsigned int> goalNodeCounts;
+	static std::vector< std::pair<std::uint64_t, GoalField*> > newGoalFields;
+	static std::vector< std::tuple<int, unsigned int, std::uint64_t> > evictionOrder;
+
+	goalNodeCounts.clear();
+	newGoalFields.clear();
+	evictionOrder.clear();
+
+	auto pathView = registry.group<PathSearch, ProcessPath>();
+
+	const auto getGoalFieldKey = [this](const PathSearch* search) -> std::uint64_t {
+		const IPath* path = registry.try_get<IPath>((entt::entity)search->GetID());
+
+		if (path == nullptr)
+			return -1ull;
+
+		const float3& goalPos = path->GetGoalPosition();
+		const INode* goalNode = nodeLayers[search->GetPathType()].GetNode(goalPos.x / SQUARE_SIZE, goalPos.z / SQUARE_SIZE);
+
+		if (goalNode->AllSquaresImpassable())
+			return -1ull;
+
+		return ((std::uint64_t(search->GetPathType()) << 32) | goalNode->GetIndex());
+	};
+	const auto canUseGoalField = [](const PathSearch* search) {
+		// grouping unsynced searches would make the heuristic of synced ones differ per client
+		return (search->synced && !search->rawPathCheck && !search->tryPathRepair);
+	};
+
+	for (entt::entity entity: pathView) {
+		PathSearch* search = &pathView.get<PathSearch>(entity);
+		search->goalField = nullptr;
+
+		if (!canUseGoalField(search))
+			continue;
+
+		const std::uint64_t key = getGoalFieldKey(search);
+
+		if (key != -1ull)
+			goalNodeCounts[key] += 1;
+	}
+
+	for (auto it = goalFields.begin(); it != goalFields.end(); ) {
+		const NodeLayer& nodeLayer = nodeLayers[it->first >> 32];
+		const bool layerChanged = (it->second.GetRegionVersion() != nodeLayer.GetRegionGraph().GetVersion());
+		const bool expired = ((gs->frameNum - it->second.GetLastUsedFrame()) > GOAL_FIELD_LIFETIME);
+
+		if (layerChanged || expired) {
+			it = goalFields.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	for (const auto& pair: goalNodeCounts) {
+		if (pair.second < MIN_GOAL_FIELD_SEARCHES)
+			continue;
+
+		goalFields[pair.first].SetLastUsedFrame(gs->frameNum);
+	}
+
+	// each field costs a few bytes per node edge of the layer (several MB on
+	// large maps), keep only the most recently and then most widely used ones
+	if (goalFields.size() > MAX_GOAL_FIELDS) {
+		for (const auto& pair: goalFields) {
+			const auto it = goalNodeCounts.find(pair.first);
+			const unsigned int count = (it != goalNodeCounts.end())? it->second: 0;
+
+			evictionOrder.emplace_back(pair.second.GetLastUsedFrame(), count, pair.first);
+		}
+
+		// sorted on the key last as well, the map order differs between clients
+		std::sort(evictionOrder.begin(), evictionOrder.end(), std::greater<>());
+
+		for (size_t i = MAX_GOAL_FIELDS; i < evictionOrder.size(); i++) {
+			goalFields.erase(std::get<2>(evictionOrder[i]));
+		}
+	}
+
+	if (goalFields.empty())
+		return;
+
+	// only take pointers once all insertions are done
+	for (auto& pair: goalFields) {
+		if (pair.second.GetGoalNodeIndex() == -1u)
+			newGoalFields.emplace_back(pair.first, &pair.second);
+	}
+
+	for_mt(0, newGoalFields.size(), [this](int i) {
+		const std::uint64_t key = newGoalFields[i].first;
+		newGoalFields[i].second->Build(nodeLayers[key >> 32], std::uint32_t(key));
+	});
+
+	for (entt::entity entity: pathView) {
+		PathSearch* search = &pathView.get<PathSearch>(entity);
+
+		if (!canUseGoalField(search))
+			continue;
+
+		const auto it = goalFields.find(getGoalFieldKey(search));
+
+		if (it == goalFields.end() || it->second.GetLastUsedFrame() != gs->frameNum)
+			continue;
+
+		search->goalField = &it->second;
+	}
+}
+
 void QTPFS::PathManager::ExecuteQueuedSearches() {
 	ZoneScoped;
 
 	ReadyQueuedSearches();
 
+	if (MIN_GOAL_FIELD_SEARCHES > 0)
+		AssignGoalFields();
+
 	auto pathView = registry.group<PathSearch, ProcessPath>();
 
 	// execute pending searches collected via
@@ -1243,6 +1440,7 @@ unsigned int QTPFS::PathManager::QueueSearch(
 	newSearch->allowPartialSearch = !allowRawSearch;
 	newSearch->initialized = false;
 	newSearch->synced = synced;
+	newSearch->syncedSeqNum = synced? ++numSyncedSearches: 0;
 
 	// LOG("%s: %s (%x) %d -> %d ", __func__
 	// 		, unit != nullptr ? unit->unitDef->name.c_str() : "non-unit"
@@ -1312,6 +1510,7 @@ unsigned int QTPFS::PathManager::RequeueSearch(
 	newSearch->initialized = false;
 	newSearch->allowPartialSearch = allowPartialSearch;
 	newSearch->synced = oldPath->IsSynced();
+	newSearch->syncedSeqNum = newSearch->synced? ++numSyncedSearches: 0;
 
 	newSearch->tryPathRepair = allowRepair;
 
@@ -1680,3 +1879,76 @@ int2 QTPFS::PathManager::GetNumQueuedUpdates() const {
 
 	return data;
 }
+
+void QTPFS::PathManager::RunSearchBenchmark(unsigned int pathType, unsigned int numSearches, unsigned int seed) {
+	RECOIL_DETAILED_TRACY_ZONE;
+	assert(!ThreadPool::inMultiThreadedSection);
+
+	if (!IsFinalized() || pathType >= nodeLayers.size() || numSearches == 0)
+		return;
+
+	NodeLayer& nodeLayer = nodeLayers[pathType];
+	SearchThreadData& threadData = searchThreadData[ThreadPool::GetThreadNum()];
+
+	// unsynced rng, must not touch the synced one
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> xDist(0.0f, float(mapDims.mapx * SQUARE_SIZE - 1));
+	std::uniform_real_distribution<float> zDist(0.0f, float(mapDims.mapy * SQUARE_SIZE - 1));
+
+	std::vector<float> searchTimes;
+	std::vector<size_t> nodesSearched;
+
+	searchTimes.reserve(numSearches);
+	nodesSearched.reserve(numSearches);
+
+	unsigned int numFound = 0;
+
+	for (unsigned int n = 0; n < numSearches; n++) {
+		const float3 sourcePoint = {xDist(rng), 0.0f, zDist(rng)};
+		const float3 targetPoint = {xDist(rng), 0.0f, zDist(rng)};
+
+		// same setup as QueueSearch, minus the registry
+		IPath path;
+		PathSearch search(PATH_SEARCH_ASTAR);
+
+		path.SetRadius(SQUARE_SIZE);
+		path.AllocPoints(2);
+		path.AllocNodes(0);
+		path.SetSourcePoint(sourcePoint);
+		path.SetTargetPoint(targetPoint);
+		path.SetGoalPosition(targetPoint);
+		path.SetPathType(pathType);
+
+		search.SetPathType(pathType);
+		search.SetGoalDistance(path.GetRadius());
+
+		const spring_time startTime = spring_gettime();
+
+		search.Initialize(&nodeLayer, sourcePoint, targetPoint, nullptr);
+		search.InitializeThread(&threadData);
+
+		if (search.Execute(searchStateOffset)) {
+			search.Finalize(&path);
+			numFound += search.PathWasFound();
+		}
+
+		searchTimes.push_back((spring_gettime() - startTime).toMilliSecsf());
+		nodesSearched.push_back(search.GetNumNodesSearched());
+	}
+
+	const auto GetPercentile = [](auto& values, float p) {
+		const size_t idx = std::min(values.size() - 1, size_t(values.size() * p));
+
+		std::nth_element(values.begin(), values.begin() + idx, values.end());
+		return values[idx];
+	};
+
+	LOG("[QTPFS::%s] layer=%u searches=%u found=%u seed=%u", __func__, pathType, numSearches, numFound, seed);
+	LOG("[QTPFS::%s]   time (ms): p50=%.3f p99=%.3f", __func__, GetPercentile(searchTimes, 0.5f), GetPercentile(searchTimes, 0.99f));
+	LOG("[QTPFS::%s]   nodes searched: p50=%u p99=%u", __func__, unsigned(GetPercentile(nodesSearched, 0.5f)), unsigned(GetPercentile(nodesSearched, 0.99f)));
+	LOG("[QTPFS::%s]   footprint: layer=%" PRIu64 "KB search-thread=%" PRIu64 "KB total=%" PRIu64 "MB", __func__,
+		nodeLayer.GetMemFootPrint() / 1024,
+		std::uint64_t(threadData.GetMemFootPrint()) / 1024,
+		GetMemFootPrint()
+	);
+}
@@ -7,6 +7,7 @@
 
 #include "Sim/Misc/ModInfo.h"
 #include "Sim/Path/IPathManager.h"
+#include "GoalField.h"
 #include "NodeLayer.h"
 #include "PathCache.h"
 #include "PathSearch.h"
@@ -91,6 +92,16 @@ namespace QTPFS {
 
 		const spring::unordered_map<unsigned int, PathSearchTrace::Execution*>& GetPathTraces() const { return pathTraces; }
 
+		// runs <numSearches> searches between random points of the given layer
+		// outside the queue (no caching, sharing or repairs) and logs timings
+		// and footprints; unsynced, leaves the pathfinder state untouched
+		// NOTE:
+		//   needs a loaded game, the QTPFS sources can not be linked into a
+		//   unit test (UNIT_TEST builds reject myGL.h, which MapInfo pulls in)
+		//   only QTPFS is measured: there is no HAPFS comparison, and since
+		//   the searches bypass the path cache no cache hit rates either
+		void RunSearchBenchmark(unsigned int pathType, unsigned int numSearches, unsigned int seed);
+
 	private:
 		void MapChanged(int x1, int z1, int x2, int z2);
 
@@ -112,6 +123,7 @@ namespace QTPFS {
 		typedef spring::unordered_map<PathHashType, entt::entity>::iterator SharedPathMapIt;
 		typedef spring::unordered_map<PathHashType, entt::entity> PartialSharedPathMap;
 		typedef spring::unordered_map<PathHashType, entt::entity>::iterator PartialSharedPathMapIt;
+		typedef spring::unordered_map<std::uint64_t, GoalField> GoalFieldMap;
 
 		typedef std::vector<PathSearch*> PathSearchVect;
 		typedef std::vector<PathSearch*>::iterator PathSearchVectIt;
@@ -126,7 +138,9 @@ namespace QTPFS {
 		void RemovePathFromPartialShared(entt::entity entity);
 		void RemovePathSearch(entt::entity pathEntity);
 
+		void DeferQueuedSearches();
 		void ReadyQueuedSearches();
+		void AssignGoalFields();
 		void ExecuteQueuedSearches();
 		void QueueDeadPathSearches();
 
@@ -173,6 +187,8 @@ namespace QTPFS {
 		PathTraceMap pathTraces;
 		SharedPathMap sharedPaths;
 		PartialSharedPathMap partialSharedPaths;
+		// keyed by (pathType << 32 | goal node index)
+		GoalFieldMap goalFields;
 
 		// std::vector<unsigned int> numCurrExecutedSearches;
 		// std::vector<unsigned int> numPrevExecutedSearches;
@@ -185,9 +201,13 @@ namespace QTPFS {
 
 		static unsigned int LAYERS_PER_UPDATE;
 		static unsigned int MAX_TEAM_SEARCHES;
+		static unsigned int MAX_SEARCHES_PER_FRAME;
+		static unsigned int MIN_GOAL_FIELD_SEARCHES;
+		static unsigned int MAX_GOAL_FIELDS;
 
 		unsigned int searchStateOffset;
 		unsigned int numPathRequests;
+		unsigned int numSyncedSearches;
 
 		std::int32_t refreshDirtyPathRateFrame = QTPFS_LAST_FRAME;
 		std::int32_t updateDirtyPathRate = 0;
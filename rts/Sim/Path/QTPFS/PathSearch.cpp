@@ -6,6 +6,7 @@
 #include <limits>
 
 #include "PathSearch.h"
+#include "GoalField.h"
 #include "Path.h"
 #include "PathCache.h"
 #include "Map/MapInfo.h"
@@ -149,6 +150,7 @@ void QTPFS::PathSearch::Initialize(
 void QTPFS::PathSearch::InitializeThread(SearchThreadData* threadData) {
 	ZoneScoped;
 	searchThreadData = threadData;
+	corridorGraph = nullptr;
 
 	badGoal = false;
 
@@ -248,6 +250,10 @@ void QTPFS::PathSearch::InitializeThread(SearchThreadData* threadData) {
 		}
 	}
 
+	// the shared field only describes the goal node it was built for
+	if (goalField != nullptr && (doPathRepair || badGoal || tgtNode->GetIndex() != goalField->GetGoalNodeIndex()))
+		goalField = nullptr;
+
 	fwd.srcSearchNode = &searchThreadData->allSearchedNodes[SearchThreadData::SEARCH_FORWARD].InsertINode(srcNode->GetIndex());
 	fwd.tgtSearchNode = &searchThreadData->allSearchedNodes[SearchThreadData::SEARCH_FORWARD].InsertINodeIfNotPresent(tgtNode->GetIndex());
 
@@ -269,8 +275,7 @@ void QTPFS::PathSearch::InitializeThread(SearchThreadData* threadData) {
 		data.openNodes = &searchThreadData->openNodes[i];
 		data.minSearchNode = data.srcSearchNode;
 
-		while (!data.openNodes->empty())
-			data.openNodes->pop();
+		searchThreadData->ResetQueue(i);
 	}
 
 	// Set search boundaries for path repairs. If a repair cannot be made within the boundaries then the path is better
@@ -590,6 +595,64 @@ void QTPFS::PathSearch::InitStartingSearchNodes() {
 	}
 }
 
+void QTPFS::PathSearch::InitSearchCorridor() {
+	RECOIL_DETAILED_TRACY_ZONE;
+	corridorGraph = nullptr;
+
+	// repairs are boxed in already and partial searches head for a shared path instead of the goal
+	if (doPathRepair || doPartialSearch)
+		return;
+
+	const RegionGraph& regionGraph = nodeLayer->GetRegionGraph();
+
+	// searches run before the frame's layer updates, so this only happens while a layer is being initialized
+	if (regionGraph.IsDirty())
+		return;
+
+	const INode* srcNode = nodeLayer->GetPoolNode(directionalSearchData[SearchThreadData::SEARCH_FORWARD].srcSearchNode->GetIndex());
+	const INode* tgtNode = nodeLayer->GetPoolNode(directionalSearchData[SearchThreadData::SEARCH_BACKWARD].srcSearchNode->GetIndex());
+
+	const int srcRegion = regionGraph.GetRegion(*nodeLayer, srcNode->xmin(), srcNode->zmin());
+	const int tgtRegion = regionGraph.GetRegion(*nodeLayer, tgtNode->xmin(), tgtNode->zmin());
+
+	std::vector<int>& coarseRoute = searchThreadData->coarseRoute;
+
+	// unreachable goals keep the full search, which still yields the closest partial path
+	if (!regionGraph.FindCoarseRoute(srcRegion, tgtRegion, coarseRoute))
+		return;
+	if (coarseRoute.size() < QTPFS_CORRIDOR_MIN_ROUTE_REGIONS)
+		return;
+
+	std::vector<std::uint32_t>& regionStamps = searchThreadData->corridorRegionStamps;
+	const std::uint32_t corridorStamp = ++searchThreadData->corridorStamp;
+
+	if (regionStamps.size() < regionGraph.GetNumRegions())
+		regionStamps.resize(regionGraph.GetNumRegions(), 0);
+
+	// consecutive route regions are linked through neighbouring leafs, so the corridor always
+	// connects source and target; it is widened by one ring of regions because the route is
+	// only costed between region centres
+	for (const int regionIdx: coarseRoute) {
+		regionStamps[regionIdx] = corridorStamp;
+
+		for (const int ngbRegionIdx: regionGraph.GetRegionData(regionIdx).neighbours) {
+			regionStamps[ngbRegionIdx] = corridorStamp;
+		}
+	}
+
+	corridorGraph = &regionGraph;
+}
+
+bool QTPFS::PathSearch::IsInSearchCorridor(unsigned int nodeIndex) const {
+	const int regionIdx = corridorGraph->GetNodeRegion(nodeIndex);
+
+	// closed nodes have no region, the search only enters them when it starts or ends in one
+	if (regionIdx < 0)
+		return true;
+
+	return (searchThreadData->corridorRegionStamps[regionIdx] == searchThreadData->corridorStamp);
+}
+
 void QTPFS::PathSearch::UpdateHcostMult() {
 	RECOIL_DETAILED_TRACY_ZONE;
 	auto& comp = systemGlobals.GetSystemComponent<PathSpeedModInfoSystemComponent>();
@@ -694,6 +757,7 @@ bool QTPFS::PathSearch::ExecutePathSearch() {
 
 	UpdateHcostMult();
 	InitStartingSearchNodes();
+	InitSearchCorridor();
 
 	auto& fwd = directionalSearchData[SearchThreadData::SEARCH_FORWARD];
 	auto& fwdSearchNodes = searchThreadData->allSearchedNodes[SearchThreadData::SEARCH_FORWARD];
@@ -1432,7 +1496,10 @@ void QTPFS::PathSearch::IterateNodeNeighbors(const INode* curNode, unsigned int
 		//   nightmare), while in the second we would get low-quality paths (player
 		//   nightmare)
 		int nxtNodesId = nxtNodes[i].nodeId;
-		
+
+		if (corridorGraph != nullptr && !IsInSearchCorridor(nxtNodesId))
+			continue;
+
 		// LOG("%s: target node search from %d to %d", __func__
 		// 		, curNode->GetIndex()
 		// 		, nxtNode->GetIndex()
@@ -1486,7 +1553,10 @@ void QTPFS::PathSearch::IterateNodeNeighbors(const INode* curNode, unsigned int
 		float gCost =
 			curSearchNode->GetPathCost(NODE_PATH_COST_G) +
 			curNodeSanitizedCost * gDist;
-		const float hCost = hDist * hCostMult * float(!isTarget);
+		float hCost = hDist * hCostMult * float(!isTarget);
+
+		if (goalField != nullptr && hCostMult != 0.0f && searchDir == SearchThreadData::SEARCH_FORWARD && !isTarget)
+			hCost = goalField->GetRemainingCost(curNode->GetIndex(), i, hCost);
 
 		if (isTarget) {
 			gCost += nxtNode->GetMoveCost() * hDist;
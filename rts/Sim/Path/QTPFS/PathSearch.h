@@ -14,9 +14,11 @@
 struct CollisionVolume;
 
 namespace QTPFS {
+	struct GoalField;
 	struct IPath;
 	struct NodeLayer;
 	struct PathCache;
+	struct RegionGraph;
 	struct SearchNode;
 
 	namespace PathSearchTrace {
@@ -130,6 +132,8 @@ namespace QTPFS {
 
 		void SetGoalDistance(float dist) { goalDistance = dist; }
 
+		size_t GetNumNodesSearched() const { return (fwdNodesSearched + bwdNodesSearched); }
+
 		const CSolidObject* Getowner() const { return pathOwner; }
 
 	private:
@@ -176,6 +180,8 @@ namespace QTPFS {
 		int SmoothPathPoints(const INode* nn0, const INode* nn1, const float3& p0, const float3& p1, const float3& p2, float3& result) const;
 
 		void InitStartingSearchNodes();
+		void InitSearchCorridor();
+		bool IsInSearchCorridor(unsigned int nodeIndex) const;
 		void UpdateHcostMult();
 		void RemoveOutdatedOpenNodesFromQueue(int searchDir);
 		bool IsNodeActive(const SearchNode& curSearchNode) const;
@@ -240,6 +246,9 @@ namespace QTPFS {
 
 		int fwdNodeSearchLimit = 0;
 
+		// set while the leaf search is restricted to the regions along a coarse route
+		const RegionGraph* corridorGraph = nullptr;
+
 		size_t fwdNodesSearched = 0;
 		size_t bwdNodesSearched = 0;
 
@@ -259,6 +268,15 @@ public:
 		bool expectIncompletePartialSearch = false;
 		bool searchEarlyDrop = false;
 		bool initialized = false;
+		// held back this frame by the per-frame search cap, and for how many frames so far
+		bool deferred = false;
+		unsigned int deferredFrames = 0;
+		// order in which synced searches were queued, identical on all clients
+		unsigned int syncedSeqNum = 0;
+
+		// shared by a large group heading to the same goal node, see PathManager::AssignGoalFields
+		const GoalField* goalField = nullptr;
+
 		bool partialReverseTrace = false;
 		bool doPathRepair = false;
 
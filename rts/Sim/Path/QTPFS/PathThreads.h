@@ -7,6 +7,7 @@
 #include <vector>
 
 #include "Node.h"
+#include "SearchQueue.h"
 
 #include "Map/ReadMap.h"
 #include "Sim/MoveTypes/MoveDefHandler.h"
@@ -89,29 +90,6 @@ namespace QTPFS {
         }
     };
 
-    struct SearchQueueNode {
-        SearchQueueNode(int index, float newPriorty)
-            : heapPriority(newPriorty)
-            , nodeIndex(index)
-            {}
-
-        float heapPriority;
-        int nodeIndex;
-    };
-
-    /// Functor to define node priority.
-    /// Needs to guarantee stable ordering, even if the sorting algorithm itself is not stable.
-    struct ShouldMoveTowardsBottomOfPriorityQueue {
-        inline bool operator() (const SearchQueueNode& lhs, const SearchQueueNode& rhs) const {
-            return std::tie(lhs.heapPriority, lhs.nodeIndex) > std::tie(rhs.heapPriority, rhs.nodeIndex);
-        }
-    };
-
-
-    // Reminder that std::priority does comparisons to push element back to the bottom. So using
-    // ShouldMoveTowardsBottomOfPriorityQueue here means the smallest value will be top()
-    typedef std::priority_queue<SearchQueueNode, std::vector<SearchQueueNode>, ShouldMoveTowardsBottomOfPriorityQueue> SearchPriorityQueue;
-
 	struct SearchThreadData {
 
         static constexpr int SEARCH_FORWARD = 0;
@@ -121,6 +99,12 @@ namespace QTPFS {
 		SparseData<SearchNode> allSearchedNodes[SEARCH_DIRECTIONS];
         SearchPriorityQueue openNodes[SEARCH_DIRECTIONS];
         std::vector<INode*> tmpNodesStore;
+
+        // region corridor of the current search, see PathSearch::InitSearchCorridor
+        std::vector<int> coarseRoute;
+        std::vector<std::uint32_t> corridorRegionStamps;
+        std::uint32_t corridorStamp = 0;
+
         int threadId = 0;
 
 		SearchThreadData(size_t nodeCount, int curThreadId)
@@ -130,7 +114,14 @@ namespace QTPFS {
 
         void ResetQueue() { ZoneScoped; for (int i=0; i<SEARCH_DIRECTIONS; ++i) ResetQueue(i); }
 
-        void ResetQueue(int i) { ZoneScoped; while (!openNodes[i].empty()) openNodes[i].pop(); }
+        void ResetQueue(int i) {
+            ZoneScoped;
+            #ifdef QTPFS_QUATERNARY_SEARCH_QUEUE
+            openNodes[i].clear();
+            #else
+            while (!openNodes[i].empty()) openNodes[i].pop();
+            #endif
+        }
 
 		void Init(size_t sparseSize, size_t denseSize) {
             constexpr size_t tmpNodeStoreInitialReserve = 128;
@@ -151,6 +142,8 @@ namespace QTPFS {
                 memFootPrint += openNodes[i].size() * sizeof(std::remove_reference_t<decltype(openNodes[0])>::value_type);
             }
             memFootPrint += tmpNodesStore.size() * sizeof(decltype(tmpNodesStore)::value_type);
+            memFootPrint += coarseRoute.size() * sizeof(decltype(coarseRoute)::value_type);
+            memFootPrint += corridorRegionStamps.size() * sizeof(decltype(corridorRegionStamps)::value_type);
 
             return memFootPrint;
         }
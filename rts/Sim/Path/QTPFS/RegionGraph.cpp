@@ -0,0 +1,421 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+
+#include "RegionGraph.h"
+#include "NodeLayer.h"
+#include "Node.h"
+
+#include "Sim/Misc/GlobalConstants.h"
+
+#include "System/Misc/TracyDefs.h"
+
+// marks a passable leaf that has not been assigned to a region yet
+static constexpr int UNASSIGNED_REGION = -2;
+
+
+void QTPFS::RegionGraph::Init(const NodeLayer& nodeLayer) {
+	RECOIL_DETAILED_TRACY_ZONE;
+	Clear();
+
+	const int numRoots = nodeLayer.GetRootNodeCount();
+
+	rootRegions.resize(numRoots);
+	rootDirtyFlags.assign(numRoots, 1);
+	dirtyRoots.reserve(numRoots);
+
+	for (int i = 0; i < numRoots; ++i)
+		dirtyRoots.push_back(i);
+}
+
+void QTPFS::RegionGraph::Clear() {
+	RECOIL_DETAILED_TRACY_ZONE;
+	regions.clear();
+	freeRegions.clear();
+	rootRegions.clear();
+	rootDirtyFlags.clear();
+	dirtyRoots.clear();
+	nodeRegions.clear();
+}
+
+
+void QTPFS::RegionGraph::MarkDirty(const NodeLayer& nodeLayer, const SRectangle& r) {
+	const int rootSize = nodeLayer.GetRootNodeSize();
+	const int xRoots = nodeLayer.GetXRootNodes();
+	const int zRoots = nodeLayer.GetZRootNodes();
+
+	if (rootSize <= 0)
+		return;
+
+	const int x1 = std::clamp(r.x1 / rootSize, 0, xRoots - 1);
+	const int z1 = std::clamp(r.z1 / rootSize, 0, zRoots - 1);
+	const int x2 = std::clamp((r.x2 - 1) / rootSize, 0, xRoots - 1);
+	const int z2 = std::clamp((r.z2 - 1) / rootSize, 0, zRoots - 1);
+
+	for (int z = z1; z <= z2; ++z) {
+		for (int x = x1; x <= x2; ++x) {
+			const int rootIndex = z * xRoots + x;
+
+			if (rootDirtyFlags[rootIndex] != 0)
+				continue;
+
+			rootDirtyFlags[rootIndex] = 1;
+			dirtyRoots.push_back(rootIndex);
+		}
+	}
+}
+
+void QTPFS::RegionGraph::Update(const NodeLayer& nodeLayer) {
+	RECOIL_DETAILED_TRACY_ZONE;
+	if (dirtyRoots.empty())
+		return;
+
+	if (nodeRegions.size() < size_t(nodeLayer.GetMaxNodesAlloced()))
+		nodeRegions.resize(nodeLayer.GetMaxNodesAlloced(), NO_REGION);
+
+	// keep region index allocation independent of the order of the damage updates
+	std::sort(dirtyRoots.begin(), dirtyRoots.end());
+
+	for (const int rootIndex: dirtyRoots) {
+		BuildRootRegions(nodeLayer, rootIndex);
+	}
+
+	// links into a rebuilt root are stale on both sides of its borders
+	const int xRoots = nodeLayer.GetXRootNodes();
+	const int zRoots = nodeLayer.GetZRootNodes();
+
+	linkRoots.clear();
+
+	for (const int rootIndex: dirtyRoots) {
+		const int rx = rootIndex % xRoots;
+		const int rz = rootIndex / xRoots;
+
+		for (int z = std::max(rz - 1, 0); z <= std::min(rz + 1, zRoots - 1); ++z) {
+			for (int x = std::max(rx - 1, 0); x <= std::min(rx + 1, xRoots - 1); ++x) {
+				linkRoots.push_back(z * xRoots + x);
+			}
+		}
+
+		rootDirtyFlags[rootIndex] = 0;
+	}
+
+	std::sort(linkRoots.begin(), linkRoots.end());
+	linkRoots.erase(std::unique(linkRoots.begin(), linkRoots.end()), linkRoots.end());
+
+	for (const int rootIndex: linkRoots) {
+		LinkRootRegions(nodeLayer, rootIndex);
+	}
+
+	dirtyRoots.clear();
+	UpdateComponents();
+
+	version += 1;
+}
+
+
+int QTPFS::RegionGraph::AllocRegion() {
+	if (freeRegions.empty()) {
+		regions.emplace_back();
+		return (regions.size() - 1);
+	}
+
+	const int regionIdx = freeRegions.back();
+	freeRegions.pop_back();
+	return regionIdx;
+}
+
+void QTPFS::RegionGraph::FreeRootRegions(int rootIndex) {
+	for (const int regionIdx: rootRegions[rootIndex]) {
+		Region& region = regions[regionIdx];
+
+		region.neighbours.clear();
+		region.rootIndex = -1;
+		region.component = -1;
+		region.numNodes = 0;
+
+		freeRegions.push_back(regionIdx);
+	}
+
+	rootRegions[rootIndex].clear();
+
+	// hand out the lowest free indices first
+	std::sort(freeRegions.begin(), freeRegions.end(), std::greater<int>());
+}
+
+int QTPFS::RegionGraph::GetRootIndex(const NodeLayer& nodeLayer, const INode* node) const {
+	const int rootSize = nodeLayer.GetRootNodeSize();
+	return ((node->zmin() / rootSize) * nodeLayer.GetXRootNodes() + (node->xmin() / rootSize));
+}
+
+
+void QTPFS::RegionGraph::BuildRootRegions(const NodeLayer& nodeLayer, int rootIndex) {
+	FreeRootRegions(rootIndex);
+
+	std::vector<int> leafs;
+
+	// collect the current leafs of this root; internal nodes never carry a region
+	nodeStack.clear();
+	nodeStack.push_back(rootIndex);
+
+	while (!nodeStack.empty()) {
+		const int nodeIndex = nodeStack.back();
+		const INode* node = nodeLayer.GetPoolNode(nodeIndex);
+
+		nodeStack.pop_back();
+
+		if (!node->IsLeaf()) {
+			nodeRegions[nodeIndex] = NO_REGION;
+
+			for (unsigned int i = 0; i < 4; ++i) {
+				nodeStack.push_back(node->GetChildBaseIndex() + i);
+			}
+			continue;
+		}
+
+		if (node->AllSquaresImpassable()) {
+			nodeRegions[nodeIndex] = NO_REGION;
+			continue;
+		}
+
+		nodeRegions[nodeIndex] = UNASSIGNED_REGION;
+		leafs.push_back(nodeIndex);
+	}
+
+	// flood-fill the leafs into regions; neighbours in other roots are never
+	// UNASSIGNED_REGION, so the fill stays inside this root
+	for (const int leafIndex: leafs) {
+		if (nodeRegions[leafIndex] != UNASSIGNED_REGION)
+			continue;
+
+		const int regionIdx = AllocRegion();
+		float3 centreSum;
+		float areaSum = 0.0f;
+		int numNodes = 0;
+
+		nodeRegions[leafIndex] = regionIdx;
+		nodeStack.push_back(leafIndex);
+
+		while (!nodeStack.empty()) {
+			const INode* node = nodeLayer.GetPoolNode(nodeStack.back());
+			const float area = node->area();
+
+			nodeStack.pop_back();
+
+			centreSum += float3(node->xmid() * SQUARE_SIZE, 0.0f, node->zmid() * SQUARE_SIZE) * area;
+			areaSum += area;
+			numNodes += 1;
+
+			for (const auto& neighbour: node->GetNeighbours()) {
+				const int ngbIndex = neighbour.nodeId;
+
+				if (size_t(ngbIndex) >= nodeRegions.size() || nodeRegions[ngbIndex] != UNASSIGNED_REGION)
+					continue;
+
+				nodeRegions[ngbIndex] = regionIdx;
+				nodeStack.push_back(ngbIndex);
+			}
+		}
+
+		Region& region = regions[regionIdx];
+		region.centre = centreSum / std::max(areaSum, 1.0f);
+		region.rootIndex = rootIndex;
+		region.numNodes = numNodes;
+
+		rootRegions[rootIndex].push_back(regionIdx);
+	}
+}
+
+void QTPFS::RegionGraph::LinkRootRegions(const NodeLayer& nodeLayer, int rootIndex) {
+	for (const int regionIdx: rootRegions[rootIndex]) {
+		regions[regionIdx].neighbours.clear();
+	}
+
+	nodeStack.clear();
+	nodeStack.push_back(rootIndex);
+
+	while (!nodeStack.empty()) {
+		const int nodeIndex = nodeStack.back();
+		const INode* node = nodeLayer.GetPoolNode(nodeIndex);
+
+		nodeStack.pop_back();
+
+		if (!node->IsLeaf()) {
+			for (unsigned int i = 0; i < 4; ++i) {
+				nodeStack.push_back(node->GetChildBaseIndex() + i);
+			}
+			continue;
+		}
+
+		const int regionIdx = nodeRegions[nodeIndex];
+
+		if (regionIdx == NO_REGION)
+			continue;
+
+		std::vector<int>& regionNeighbours = regions[regionIdx].neighbours;
+
+		for (const auto& neighbour: node->GetNeighbours()) {
+			if (size_t(neighbour.nodeId) >= nodeRegions.size())
+				continue;
+
+			const int ngbRegionIdx = nodeRegions[neighbour.nodeId];
+
+			if (ngbRegionIdx < 0 || ngbRegionIdx == regionIdx)
+				continue;
+			if (std::find(regionNeighbours.begin(), regionNeighbours.end(), ngbRegionIdx) != regionNeighbours.end())
+				continue;
+
+			regionNeighbours.push_back(ngbRegionIdx);
+		}
+	}
+}
+
+void QTPFS::RegionGraph::UpdateComponents() {
+	RECOIL_DETAILED_TRACY_ZONE;
+	std::vector<int> parents(regions.size());
+
+	for (size_t i = 0; i < parents.size(); ++i)
+		parents[i] = i;
+
+	const auto findRoot = [&parents](int i) {
+		while (parents[i] != i) {
+			parents[i] = parents[parents[i]];
+			i = parents[i];
+		}
+		return i;
+	};
+
+	// links are treated as undirected, the lowest region index labels each component
+	for (size_t i = 0; i < regions.size(); ++i) {
+		if (regions[i].rootIndex < 0)
+			continue;
+
+		for (const int ngbRegionIdx: regions[i].neighbours) {
+			const int a = findRoot(i);
+			const int b = findRoot(ngbRegionIdx);
+
+			parents[std::max(a, b)] = std::min(a, b);
+		}
+	}
+
+	for (size_t i = 0; i < regions.size(); ++i) {
+		regions[i].component = (regions[i].rootIndex < 0)? -1: findRoot(i);
+	}
+}
+
+
+int QTPFS::RegionGraph::GetNodeRegion(const INode* node) const {
+	return GetNodeRegion(node->GetIndex());
+}
+
+int QTPFS::RegionGraph::GetRegion(const NodeLayer& nodeLayer, unsigned int x, unsigned int z) const {
+	const INode* node = nodeLayer.GetNode(x, z);
+	const int regionIdx = GetNodeRegion(node);
+
+	if (regionIdx != NO_REGION)
+		return regionIdx;
+
+	// objects inside a closed node can still escape through its neighbours
+	for (const auto& neighbour: node->GetNeighbours()) {
+		if (size_t(neighbour.nodeId) >= nodeRegions.size())
+			continue;
+		if (nodeRegions[neighbour.nodeId] < 0)
+			continue;
+
+		return nodeRegions[neighbour.nodeId];
+	}
+
+	return NO_REGION;
+}
+
+bool QTPFS::RegionGraph::IsReachable(const NodeLayer& nodeLayer, const float3& srcPos, const float3& tgtPos) const {
+	const float3 srcPoint = srcPos.cClampInBounds();
+	const float3 tgtPoint = tgtPos.cClampInBounds();
+
+	const int srcRegion = GetRegion(nodeLayer, srcPoint.x / SQUARE_SIZE, srcPoint.z / SQUARE_SIZE);
+	const int tgtRegion = GetRegion(nodeLayer, tgtPoint.x / SQUARE_SIZE, tgtPoint.z / SQUARE_SIZE);
+
+	if (srcRegion == NO_REGION || tgtRegion == NO_REGION)
+		return false;
+
+	return (regions[srcRegion].component == regions[tgtRegion].component);
+}
+
+bool QTPFS::RegionGraph::FindCoarseRoute(int srcRegion, int tgtRegion, std::vector<int>& route) const {
+	RECOIL_DETAILED_TRACY_ZONE;
+	route.clear();
+
+	if (srcRegion == NO_REGION || tgtRegion == NO_REGION)
+		return false;
+	if (regions[srcRegion].component != regions[tgtRegion].component)
+		return false;
+
+	typedef std::pair<float, int> QueueEntry;
+
+	std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> openRegions;
+	std::vector<float> costs(regions.size(), std::numeric_limits<float>::infinity());
+	std::vector<int> prevRegions(regions.size(), NO_REGION);
+
+	const float3& tgtCentre = regions[tgtRegion].centre;
+
+	costs[srcRegion] = 0.0f;
+	openRegions.emplace(regions[srcRegion].centre.distance2D(tgtCentre), srcRegion);
+
+	while (!openRegions.empty()) {
+		const QueueEntry entry = openRegions.top();
+		const int curRegion = entry.second;
+
+		openRegions.pop();
+
+		if (curRegion == tgtRegion)
+			break;
+
+		const Region& region = regions[curRegion];
+
+		// stale entry
+		if (entry.first > costs[curRegion] + region.centre.distance2D(tgtCentre))
+			continue;
+
+		for (const int ngbRegion: region.neighbours) {
+			const float cost = costs[curRegion] + region.centre.distance2D(regions[ngbRegion].centre);
+
+			if (cost >= costs[ngbRegion])
+				continue;
+
+			costs[ngbRegion] = cost;
+			prevRegions[ngbRegion] = curRegion;
+			openRegions.emplace(cost + regions[ngbRegion].centre.distance2D(tgtCentre), ngbRegion);
+		}
+	}
+
+	if (srcRegion != tgtRegion && prevRegions[tgtRegion] == NO_REGION)
+		return false;
+
+	for (int regionIdx = tgtRegion; regionIdx != NO_REGION; regionIdx = prevRegions[regionIdx]) {
+		route.push_back(regionIdx);
+	}
+
+	std::reverse(route.begin(), route.end());
+	return true;
+}
+
+
+std::uint64_t QTPFS::RegionGraph::GetMemFootPrint() const {
+	std::uint64_t memFootPrint = sizeof(RegionGraph);
+
+	memFootPrint += (regions.size() * sizeof(Region));
+
+	for (const Region& region: regions) {
+		memFootPrint += (region.neighbours.size() * sizeof(int));
+	}
+	for (const auto& rootRegionIndices: rootRegions) {
+		memFootPrint += (rootRegionIndices.size() * sizeof(int));
+	}
+
+	memFootPrint += (freeRegions.size() * sizeof(int));
+	memFootPrint += (rootRegions.size() * sizeof(decltype(rootRegions)::value_type));
+	memFootPrint += (rootDirtyFlags.size() * sizeof(std::uint8_t));
+	memFootPrint += (nodeRegions.size() * sizeof(int));
+	return memFootPrint;
+}
@@ -0,0 +1,101 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef QTPFS_REGIONGRAPH_H_
+#define QTPFS_REGIONGRAPH_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "System/float3.h"
+#include "System/Rectangle.h"
+
+namespace QTPFS {
+	struct INode;
+	struct NodeLayer;
+
+	// Coarse abstraction of a node layer (in the spirit of HPA*): every root
+	// node is split into regions of mutually connected passable leaf nodes,
+	// regions that touch across root borders are linked, and each region is
+	// labelled with the connected component it belongs to. This answers map
+	// wide reachability in O(1) and coarse routes by searching a few hundred
+	// regions instead of the full quadtree.
+	//
+	// Exit-only nodes are treated as regular passable nodes, so reachability
+	// is approximate around them (eg. inside factories).
+	struct RegionGraph {
+	public:
+		static constexpr int NO_REGION = -1;
+
+		struct Region {
+			std::vector<int> neighbours;
+
+			float3 centre;
+
+			int rootIndex = -1;
+			int component = -1;
+			int numNodes = 0;
+		};
+
+		void Init(const NodeLayer& nodeLayer);
+		void Clear();
+
+		// called after <r> (in squares) was re-tesselated
+		void MarkDirty(const NodeLayer& nodeLayer, const SRectangle& r);
+		// rebuild the regions of all dirty root nodes, then the component labels
+		void Update(const NodeLayer& nodeLayer);
+
+		bool IsDirty() const { return (!dirtyRoots.empty()); }
+		// changes whenever the regions (and hence the node layer) changed
+		unsigned int GetVersion() const { return version; }
+
+		// region of the leaf node containing square (x, z); closed nodes
+		// resolve to the region of their first passable neighbour, if any
+		int GetRegion(const NodeLayer& nodeLayer, unsigned int x, unsigned int z) const;
+		int GetNodeRegion(const INode* node) const;
+		int GetNodeRegion(unsigned int nodeIndex) const {
+			return ((nodeIndex < nodeRegions.size())? nodeRegions[nodeIndex]: NO_REGION);
+		}
+
+		size_t GetNumRegions() const { return regions.size(); }
+
+		const Region& GetRegionData(int regionIdx) const { return regions[regionIdx]; }
+		int GetComponent(int regionIdx) const { return ((regionIdx == NO_REGION)? -1: regions[regionIdx].component); }
+
+		bool IsReachable(const NodeLayer& nodeLayer, const float3& srcPos, const float3& tgtPos) const;
+
+		// fills <route> with the region indices from <srcRegion> to <tgtRegion>
+		bool FindCoarseRoute(int srcRegion, int tgtRegion, std::vector<int>& route) const;
+
+		std::uint64_t GetMemFootPrint() const;
+
+	private:
+		int AllocRegion();
+		void FreeRootRegions(int rootIndex);
+
+		void BuildRootRegions(const NodeLayer& nodeLayer, int rootIndex);
+		void LinkRootRegions(const NodeLayer& nodeLayer, int rootIndex);
+		void UpdateComponents();
+
+		int GetRootIndex(const NodeLayer& nodeLayer, const INode* node) const;
+
+	private:
+		std::vector<Region> regions;
+		std::vector<int> freeRegions;
+
+		// per root node
+		std::vector<std::vector<int>> rootRegions;
+		std::vector<std::uint8_t> rootDirtyFlags;
+		std::vector<int> dirtyRoots;
+
+		// per pool node (leafs only, everything else is NO_REGION)
+		std::vector<int> nodeRegions;
+
+		// scratch buffers
+		std::vector<int> nodeStack;
+		std::vector<int> linkRoots;
+
+		unsigned int version = 0;
+	};
+}
+
+#endif
@@ -0,0 +1,140 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef QTPFS_SEARCH_QUEUE_H__
+#define QTPFS_SEARCH_QUEUE_H__
+
+#include <cassert>
+#include <algorithm>
+#include <cstddef>
+#include <queue>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// QTPFS_QUATERNARY_SEARCH_QUEUE (CMake option, off by default) selects a
+// 4-ary heap for the open-node queue instead of std::priority_queue (a
+// binary heap), see test/engine/Sim/Path/testSearchQueue.cpp
+
+namespace QTPFS {
+    struct SearchQueueNode {
+        SearchQueueNode(int index, float newPriorty)
+            : heapPriority(newPriorty)
+            , nodeIndex(index)
+            {}
+
+        float heapPriority;
+        int nodeIndex;
+    };
+
+    /// Functor to define node priority.
+    /// Needs to guarantee stable ordering, even if the sorting algorithm itself is not stable.
+    struct ShouldMoveTowardsBottomOfPriorityQueue {
+        inline bool operator() (const SearchQueueNode& lhs, const SearchQueueNode& rhs) const {
+            return std::tie(lhs.heapPriority, lhs.nodeIndex) > std::tie(rhs.heapPriority, rhs.nodeIndex);
+        }
+    };
+
+
+    /// Drop-in replacement for std::priority_queue backed by a D-ary heap.
+    /// Wider nodes halve the tree depth, so pushes do fewer swaps and pops
+    /// compare siblings that sit in the same cache line. Pop order is the
+    /// same as std::priority_queue's whenever TCompare is a total order.
+    template<typename T, typename TCompare, size_t D = 4>
+    class DAryHeap {
+    public:
+        typedef T value_type;
+        typedef size_t size_type;
+
+        bool empty() const { return nodes.empty(); }
+        size_t size() const { return nodes.size(); }
+
+        const T& top() const { assert(!empty()); return nodes.front(); }
+
+        void push(const T& n) {
+            nodes.push_back(n);
+            SiftUp(nodes.size() - 1);
+        }
+
+        template<typename... A> void emplace(A&&... args) {
+            nodes.emplace_back(std::forward<A>(args)...);
+            SiftUp(nodes.size() - 1);
+        }
+
+        void pop() {
+            assert(!empty());
+
+            if (nodes.size() > 1) {
+                nodes.front() = std::move(nodes.back());
+                nodes.pop_back();
+                SiftDown(0);
+            } else {
+                nodes.pop_back();
+            }
+        }
+
+        // unlike std::priority_queue, the heap can be emptied without popping each node
+        void clear() { nodes.clear(); }
+        void reserve(size_t n) { nodes.reserve(n); }
+
+    private:
+        void SiftUp(size_t idx) {
+            T n = std::move(nodes[idx]);
+
+            while (idx > 0) {
+                const size_t parentIdx = (idx - 1) / D;
+
+                // stop once the parent should stay above the new node
+                if (!cmp(nodes[parentIdx], n))
+                    break;
+
+                nodes[idx] = std::move(nodes[parentIdx]);
+                idx = parentIdx;
+            }
+
+            nodes[idx] = std::move(n);
+        }
+
+        void SiftDown(size_t idx) {
+            const size_t numNodes = nodes.size();
+            T n = std::move(nodes[idx]);
+
+            while (true) {
+                const size_t firstChildIdx = idx * D + 1;
+
+                if (firstChildIdx >= numNodes)
+                    break;
+
+                const size_t lastChildIdx = std::min(firstChildIdx + D, numNodes);
+                size_t bestChildIdx = firstChildIdx;
+
+                for (size_t childIdx = firstChildIdx + 1; childIdx < lastChildIdx; ++childIdx) {
+                    if (cmp(nodes[bestChildIdx], nodes[childIdx]))
+                        bestChildIdx = childIdx;
+                }
+
+                if (!cmp(n, nodes[bestChildIdx]))
+                    break;
+
+                nodes[idx] = std::move(nodes[bestChildIdx]);
+                idx = bestChildIdx;
+            }
+
+            nodes[idx] = std::move(n);
+        }
+
+    private:
+        std::vector<T> nodes;
+        TCompare cmp;
+    };
+
+
+    // Reminder that std::priority does comparisons to push element back to the bottom. So using
+    // ShouldMoveTowardsBottomOfPriorityQueue here means the smallest value will be top()
+    #ifdef QTPFS_QUATERNARY_SEARCH_QUEUE
+    typedef DAryHeap<SearchQueueNode, ShouldMoveTowardsBottomOfPriorityQueue, 4> SearchPriorityQueue;
+    #else
+    typedef std::priority_queue<SearchQueueNode, std::vector<SearchQueueNode>, ShouldMoveTowardsBottomOfPriorityQueue> SearchPriorityQueue;
+    #endif
+}
+
+#endif
@@ -65,16 +65,17 @@ CR_REG_METADATA(CUnitScript, (
 	CR_IGNORED(hasStartBuilding)
 ))
 
-CR_BIND(CUnitScript::AnimInfo,)
+CR_BIND(CUnitScript::AnimTable,)
 
-CR_REG_METADATA_SUB(CUnitScript, AnimInfo,(
+CR_REG_METADATA_SUB(CUnitScript, AnimTable,(
 	CR_MEMBER(axis),
 	CR_MEMBER(piece),
 	CR_MEMBER(speed),
 	CR_MEMBER(dest),
 	CR_MEMBER(accel),
 	CR_MEMBER(done),
-	CR_MEMBER(hasWaiting)
+	CR_MEMBER(hasWaiting),
+	CR_IGNORED(value)
 ))
 
 
@@ -171,42 +172,133 @@ bool CUnitScript::DoSpin(float& cur, float dest, float& speed, float accel, int
 	return false;
 }
 
+int CUnitScript::AnimTable::Find(int pieceNum, int axisNum) const
+{
+	for (size_t i = 0, n = size(); i < n; i++) {
+		if (piece[i] == pieceNum && axis[i] == axisNum)
+			return i;
+	}
+
+	return -1;
+}
+
+int CUnitScript::AnimTable::Add(int pieceNum, int axisNum)
+{
+	axis.push_back(axisNum);
+	piece.push_back(pieceNum);
+	speed.push_back(0.0f);
+	dest.push_back(0.0f);
+	accel.push_back(0.0f);
+	done.push_back(false);
+	hasWaiting.push_back(false);
+
+	return (size() - 1);
+}
+
+void CUnitScript::AnimTable::Remove(int row)
+{
+	axis[row] = axis.back(); axis.pop_back();
+	piece[row] = piece.back(); piece.pop_back();
+	speed[row] = speed.back(); speed.pop_back();
+	dest[row] = dest.back(); dest.pop_back();
+	accel[row] = accel.back(); accel.pop_back();
+	done[row] = done.back(); done.pop_back();
+	hasWaiting[row] = hasWaiting.back(); hasWaiting.pop_back();
+}
+
+
 /**
- * @brief The multithreaded first half of the original CUnitScript::Tick function first does the heavy lifting of calculating all
-			  new piece positions according to the animations
+ * @brief Ticks all animations of one type in three passes: gather the piece
+		  values, advance them in a loop over the table columns, then write
+		  them back. Rows of one type never share a (piece, axis) pair, so this
+		  yields the same results as ticking each animation on its own.
 */
-void CUnitScript::TickAllAnims(int deltaTime)
+template<CUnitScript::AnimType type>
+void CUnitScript::TickAnims(int tickRate)
 {
-	ZoneScoped;
+	AnimTable& table = anims[type];
 
-	// tick-functions; these never change address
-	static constexpr std::array<TickAnimFunc, AMove + 1> TICK_ANIM_FUNCS = { &CUnitScript::TickTurnAnim, &CUnitScript::TickSpinAnim, &CUnitScript::TickMoveAnim };
+	const size_t numAnims = table.size();
 
-	const int tickRate = 1000 / deltaTime;
+	if (numAnims == 0)
+		return;
 
-	for (int animType = ATurn; animType <= AMove; animType++) {
-		auto& currAnims = anims[animType];
-		const auto& currFunc = TICK_ANIM_FUNCS[animType];
-		auto& currDoneAnims = doneAnims[animType];
+	table.value.resize(numAnims);
 
-		for (size_t i = 0; i < currAnims.size(); ) {
-			AnimInfo& ai = currAnims[i];
-			LocalModelPiece& lmp = *pieces[ai.piece];
+	for (size_t i = 0; i < numAnims; i++) {
+		const LocalModelPiece* lmp = pieces[table.piece[i]];
 
-			if ((ai.done |= std::invoke(currFunc, this, tickRate, lmp, ai))) {
-				if (ai.hasWaiting)
-					currDoneAnims.emplace_back(ai);
+		if constexpr (type == AMove) {
+			table.value[i] = lmp->GetPosition()[table.axis[i]];
+		} else {
+			table.value[i] = ClampRad(lmp->GetRotation()[table.axis[i]]);
+		}
+	}
 
-				ai = std::move(currAnims.back());
-				currAnims.pop_back();
-				continue;
+	switch (type) {
+		case ATurn: {
+			for (size_t i = 0; i < numAnims; i++) {
+				table.done[i] |= TurnToward(table.value[i], table.dest[i], table.speed[i] / tickRate);
+			}
+		} break;
+		case ASpin: {
+			for (size_t i = 0; i < numAnims; i++) {
+				table.done[i] |= DoSpin(table.value[i], table.dest[i], table.speed[i], table.accel[i], tickRate);
 			}
+		} break;
+		case AMove: {
+			for (size_t i = 0; i < numAnims; i++) {
+				table.done[i] |= MoveToward(table.value[i], table.dest[i], table.speed[i] / tickRate);
+			}
+		} break;
+		default: {
+		} break;
+	}
+
+	// note: must copy-and-set here (LMP dirty flag, etc)
+	for (size_t i = 0; i < numAnims; i++) {
+		LocalModelPiece* lmp = pieces[table.piece[i]];
+
+		if constexpr (type == AMove) {
+			float3 pos = lmp->GetPosition();
+			pos[table.axis[i]] = table.value[i];
+			lmp->SetPosition(pos);
+		} else {
+			float3 rot = lmp->GetRotation();
+			rot[table.axis[i]] = table.value[i];
+			lmp->SetRotation(rot);
+		}
+	}
 
+	// remove finished rows in the order ticking them one by one would
+	for (size_t i = 0; i < table.size(); ) {
+		if (!table.done[i]) {
 			++i;
+			continue;
 		}
+
+		if (table.hasWaiting[i])
+			doneAnims[type].emplace_back(table.piece[i], table.axis[i]);
+
+		table.Remove(i);
 	}
 }
 
+/**
+ * @brief The multithreaded first half of the original CUnitScript::Tick function first does the heavy lifting of calculating all
+			  new piece positions according to the animations
+*/
+void CUnitScript::TickAllAnims(int deltaTime)
+{
+	ZoneScoped;
+
+	const int tickRate = 1000 / deltaTime;
+
+	TickAnims<ATurn>(tickRate);
+	TickAnims<ASpin>(tickRate);
+	TickAnims<AMove>(tickRate);
+}
+
 /**
 * @brief The single threaded second half of this function does the removal of finished animations,
 		and it also is responsible for unblocking the listeners and returning whether we have animations or not.
@@ -223,8 +315,8 @@ bool CUnitScript::TickAnimFinished(int deltaTime)
 	// Tell listeners to unblock, and remove finished animations from the unit/script.
 	for (int animType = ATurn; animType <= AMove; animType++) {
 		auto& currDoneAnims = doneAnims[animType];
-		for (const auto& ai : currDoneAnims)
-			AnimFinished(static_cast<AnimType>(animType), ai.piece, ai.axis);
+		for (const auto& anim: currDoneAnims)
+			AnimFinished(static_cast<AnimType>(animType), anim.first, anim.second);
 
 		currDoneAnims.clear();
 	}
@@ -232,29 +324,18 @@ bool CUnitScript::TickAnimFinished(int deltaTime)
 	return (HaveAnimations());
 }
 
-CUnitScript::AnimContainerTypeIt CUnitScript::FindAnim(AnimType type, int piece, int axis)
+void CUnitScript::RemoveAnim(AnimType type, int animRow)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
-	const auto& pred = [&](const AnimInfo& ai) { return (ai.piece == piece && ai.axis == axis); };
-	const auto& iter = std::find_if(anims[type].begin(), anims[type].end(), pred);
-	return iter;
-}
-
-void CUnitScript::RemoveAnim(AnimType type, const AnimContainerTypeIt& animInfoIt)
-{
-	RECOIL_DETAILED_TRACY_ZONE;
-	if (animInfoIt == anims[type].end())
+	if (animRow < 0)
 		return;
 
-	AnimInfo& ai = *animInfoIt;
-
 	// We need to unblock threads waiting on this animation, otherwise they will be lost in the void
 	// NOTE: AnimFinished might result in new anims being added
-	if (ai.hasWaiting)
-		AnimFinished(type, ai.piece, ai.axis);
+	if (anims[type].hasWaiting[animRow])
+		AnimFinished(type, anims[type].piece[animRow], anims[type].axis[animRow]);
 
-	ai = anims[type].back();
-	anims[type].pop_back();
+	anims[type].Remove(animRow);
 
 	// If this was the last animation, remove from currently animating list
 	// FIXME: this could be done in a cleaner way
@@ -285,8 +366,7 @@ void CUnitScript::AddAnim(AnimType type, int piece, int axis, float speed, float
 		destf = mix(dest, ClampRad(dest), type == ATurn);
 	}
 
-	AnimContainerTypeIt animInfoIt;
-	AnimInfo* ai = nullptr;
+	int animRow = -1;
 	AnimType overrideType = ANone;
 
 	// first find an animation of a type we override
@@ -296,65 +376,59 @@ void CUnitScript::AddAnim(AnimType type, int piece, int axis, float speed, float
 	switch (type) {
 		case ATurn: {
 			overrideType = ASpin;
-			animInfoIt = FindAnim(overrideType, piece, axis);
+			animRow = FindAnim(overrideType, piece, axis);
 		} break;
 		case ASpin: {
 			overrideType = ATurn;
-			animInfoIt = FindAnim(overrideType, piece, axis);
+			animRow = FindAnim(overrideType, piece, axis);
 		} break;
 		case AMove: {
 			// ensure we never remove an animation of this type
 			overrideType = AMove;
-			animInfoIt = anims[overrideType].end();
+			animRow = -1;
 		} break;
 		default: {
 		} break;
 	}
 	assert(overrideType >= 0);
 
-	if (animInfoIt != anims[overrideType].end())
-		RemoveAnim(overrideType, animInfoIt);
+	RemoveAnim(overrideType, animRow);
 
 	// now find an animation of our own type
-	animInfoIt = FindAnim(type, piece, axis);
-
-	if (animInfoIt == anims[type].end()) {
+	if ((animRow = FindAnim(type, piece, axis)) < 0) {
 		// If we were not animating before, inform the engine of this so it can schedule us
 		// FIXME: this could be done in a cleaner way
 		if (!HaveAnimations())
 			unitScriptEngine->AddInstance(this);
 
-		anims[type].emplace_back();
-		ai = &anims[type].back();
-		ai->piece = piece;
-		ai->axis = axis;
-	} else {
-		ai = &(*animInfoIt);
+		animRow = anims[type].Add(piece, axis);
 	}
 
-	ai->dest  = destf;
-	ai->speed = speed;
-	ai->accel = accel;
-	ai->done = false;
+	AnimTable& table = anims[type];
+
+	table.dest[animRow]  = destf;
+	table.speed[animRow] = speed;
+	table.accel[animRow] = accel;
+	table.done[animRow] = false;
 }
 
 
 void CUnitScript::Spin(int piece, int axis, float speed, float accel)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
-	auto animInfoIt = FindAnim(ASpin, piece, axis);
+	const int animRow = FindAnim(ASpin, piece, axis);
 
 	// if we are already spinning, we may have to decelerate to the new speed
-	if (animInfoIt != anims[ASpin].end()) {
-		AnimInfo* ai = &(*animInfoIt);
-		ai->dest = speed;
+	if (animRow >= 0) {
+		AnimTable& table = anims[ASpin];
+		table.dest[animRow] = speed;
 
 		if (accel > 0.0f) {
-			ai->accel = accel;
+			table.accel[animRow] = accel;
 		} else {
 			// Go there instantly. Or have a default accel?
-			ai->speed = speed;
-			ai->accel = 0.0f;
+			table.speed[animRow] = speed;
+			table.accel[animRow] = 0.0f;
 		}
 
 		return;
@@ -372,17 +446,16 @@ void CUnitScript::Spin(int piece, int axis, float speed, float accel)
 void CUnitScript::StopSpin(int piece, int axis, float decel)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
-	auto animInfoIt = FindAnim(ASpin, piece, axis);
+	const int animRow = FindAnim(ASpin, piece, axis);
 
 	if (decel <= 0.0f) {
-		RemoveAnim(ASpin, animInfoIt);
+		RemoveAnim(ASpin, animRow);
 	} else {
-		if (animInfoIt == anims[ASpin].end())
+		if (animRow < 0)
 			return;
 
-		AnimInfo* ai = &(*animInfoIt);
-		ai->dest = 0.0f;
-		ai->accel = decel;
+		anims[ASpin].dest[animRow] = 0.0f;
+		anims[ASpin].accel[animRow] = decel;
 	}
 }
 
@@ -701,13 +774,11 @@ void CUnitScript::DropUnit(int u)
 bool CUnitScript::NeedsWait(AnimType type, int piece, int axis)
 {
 	RECOIL_DETAILED_TRACY_ZONE;
-	auto animInfoIt = FindAnim(type, piece, axis);
+	const int animRow = FindAnim(type, piece, axis);
 
-	if (animInfoIt == anims[type].end())
+	if (animRow < 0)
 		return false;
 
-	AnimInfo& ai = *animInfoIt;
-
 	// if the animation is already finished, listening for
 	// it just adds some overhead since either the current
 	// or the next Tick will remove it and call UnblockAll
@@ -718,11 +789,11 @@ bool CUnitScript::NeedsWait(AnimType type, int piece, int axis)
 	// simply disregard the WaitFor* (no side-effects)
 	//
 	// if (ai.hasWaiting)
-	// 		AnimFinished(ai.type, ai.piece, ai.axis);
-	if (ai.done)
+	// 		AnimFinished(type, piece, axis);
+	if (anims[type].done[animRow])
 		return false;
 
-	return (ai.hasWaiting = true);
+	return (anims[type].hasWaiting[animRow] = true);
 }
 
 
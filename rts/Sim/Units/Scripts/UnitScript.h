@@ -5,7 +5,9 @@
 #ifndef UNIT_SCRIPT_H
 #define UNIT_SCRIPT_H
 
+#include <cstdint>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Rendering/Models/3DModel.h"
@@ -18,7 +20,7 @@ class CPlasmaRepulser;
 class CUnitScript
 {
 	CR_DECLARE(CUnitScript)
-	CR_DECLARE_SUB(AnimInfo)
+	CR_DECLARE_SUB(AnimTable)
 public:
 	enum AnimType {ANone = -1, ATurn = 0, ASpin = 1, AMove = 2};
 
@@ -26,24 +28,34 @@ protected:
 	CUnit* unit;
 	bool busy;
 
-	struct AnimInfo {
-		CR_DECLARE_STRUCT(AnimInfo)
-		int axis;
-		int piece;
-		float speed;
-		float dest;     // means final position when turning or moving, final speed when spinning
-		float accel;    // used for spinning, can be negative
-		bool done;
-		bool hasWaiting;
+	// active animations of one type as structure-of-arrays, so each type
+	// can be ticked by a tight loop over its columns; rows are removed by
+	// moving the last row into their place
+	struct AnimTable {
+		CR_DECLARE_STRUCT(AnimTable)
+
+		size_t size() const { return piece.size(); }
+		bool empty() const { return piece.empty(); }
+
+		int Find(int pieceNum, int axisNum) const;
+		int Add(int pieceNum, int axisNum);
+		void Remove(int row);
+
+		std::vector<int> axis;
+		std::vector<int> piece;
+		std::vector<float> speed;
+		std::vector<float> dest;  // means final position when turning or moving, final speed when spinning
+		std::vector<float> accel; // used for spinning, can be negative
+		std::vector<std::uint8_t> done;
+		std::vector<std::uint8_t> hasWaiting;
+
+		// piece position or rotation per row while ticking, not saved
+		std::vector<float> value;
 	};
 
-	typedef std::vector<AnimInfo> AnimContainerType;
-	typedef AnimContainerType::iterator AnimContainerTypeIt;
-
-	typedef bool(CUnitScript::*TickAnimFunc)(int, LocalModelPiece&, AnimInfo&);
-
-	std::array<AnimContainerType, AMove + 1> anims;
-	std::array<AnimContainerType, AMove + 1> doneAnims;
+	std::array<AnimTable, AMove + 1> anims;
+	// (piece, axis) of finished animations with listeners, per type
+	std::array<std::vector<std::pair<int, int>>, AMove + 1> doneAnims;
 
 	bool hasSetSFXOccupy;
 	bool hasRockUnit;
@@ -53,10 +65,12 @@ protected:
 	bool TurnToward(float& cur, float dest, float speed);
 	bool DoSpin(float& cur, float dest, float& speed, float accel, int divisor);
 
-	AnimContainerTypeIt FindAnim(AnimType type, int piece, int axis);
-	void RemoveAnim(AnimType type, const AnimContainerTypeIt& animInfoIt);
+	int FindAnim(AnimType type, int piece, int axis) const { return (anims[type].Find(piece, axis)); }
+	void RemoveAnim(AnimType type, int animRow);
 	void AddAnim(AnimType type, int piece, int axis, float speed, float dest, float accel);
 
+	template<AnimType type> void TickAnims(int tickRate);
+
 	virtual void ShowScriptError(const std::string& msg) = 0;
 
 	void ShowUnitScriptError(const std::string& msg);
@@ -108,10 +122,6 @@ public:
 
 	void TickAllAnims(int tickRate);
 	bool TickAnimFinished(int tickRate);
-	// note: must copy-and-set here (LMP dirty flag, etc)
-	bool TickMoveAnim(int tickRate, LocalModelPiece& lmp, AnimInfo& ai) { float3 pos = lmp.GetPosition(); const bool ret = MoveToward(pos[ai.axis], ai.dest, ai.speed / tickRate); lmp.SetPosition(pos); return ret; }
-	bool TickTurnAnim(int tickRate, LocalModelPiece& lmp, AnimInfo& ai) { float3 rot = lmp.GetRotation(); rot[ai.axis] = ClampRad(rot[ai.axis]); const bool ret = TurnToward(rot[ai.axis], ai.dest, ai.speed / tickRate         ); lmp.SetRotation(rot); return ret; }
-	bool TickSpinAnim(int tickRate, LocalModelPiece& lmp, AnimInfo& ai) { float3 rot = lmp.GetRotation(); rot[ai.axis] = ClampRad(rot[ai.axis]); const bool ret =     DoSpin(rot[ai.axis], ai.dest, ai.speed, ai.accel, tickRate); lmp.SetRotation(rot); return ret; }
 
 	// animation, used by CCobThread
 	void Spin(int piece, int axis, float speed, float accel);
@@ -138,8 +148,8 @@ public:
 	int GetUnitVal(int val, int p1, int p2, int p3, int p4);
 	void SetUnitVal(int val, int param);
 
-	bool IsInAnimation(AnimType type, int piece, int axis) {
-		return (FindAnim(type, piece, axis) != anims[type].end());
+	bool IsInAnimation(AnimType type, int piece, int axis) const {
+		return (FindAnim(type, piece, axis) >= 0);
 	}
 	bool HaveAnimations() const {
 		return (!anims[ATurn].empty() || !anims[ASpin].empty() || !anims[AMove].empty());
@@ -134,8 +134,11 @@ void CUnitScriptEngine::Tick(int deltaTime)
 		ZoneScopedN("CUnitScriptEngine::Tick(MT)");
 
 		// setting currentScript = animating[i]; is not required here, only in ST section below
+		// the moved pieces are recalculated right away while still hot in this thread's cache,
+		// instead of piece by piece whenever something later asks for their matrices
 		for_mt(0, animating.size(), [&](const int i) {
 			animating[i]->TickAllAnims(deltaTime);
+			animating[i]->GetUnit()->localModel.UpdatePieceMatrices();
 		});
 	}
 	{
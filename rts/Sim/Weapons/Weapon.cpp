@@ -719,7 +719,8 @@ bool CWeapon::AutoTarget()
 	CUnit* goodTargetUnit = nullptr;
 	CUnit*  badTargetUnit = nullptr;
 
-	auto& targetPairs = helper->targetPairs;
+	spring::ScratchArena::Scope scratchScope;
+	spring::scratch_vector<std::pair<float, CUnit*>> targetPairs;
 
 	// NOTE:
 	//   GenerateWeaponTargets sorts by INCREASING order of priority, so lower equals better
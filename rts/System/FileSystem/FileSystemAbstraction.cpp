@@ -12,6 +12,7 @@
 #include <cerrno>
 #include <cstring>
 #include <filesystem>
+#include <thread>
 
 #include <fmt/printf.h>
 #include <fmt/format.h>
@@ -181,6 +182,32 @@ bool FileSystemAbstraction::IsReadableFile(const std::string& file)
 #endif
 }
 
+bool FileSystemAbstraction::WriteFileAtomic(const std::string& file, const std::function<bool(FILE*)>& writeFunc)
+{
+#ifdef _WIN32
+	const unsigned long pid = GetCurrentProcessId();
+#else
+	const unsigned long pid = getpid();
+#endif
+	const size_t tid = std::hash<std::thread::id>{}(std::this_thread::get_id());
+	const std::string tmpFile = fmt::format("{}.{}-{:x}.tmp", file, pid, tid);
+
+	FILE* fp = fopen(tmpFile.c_str(), "wb");
+
+	if (fp == nullptr)
+		return false;
+
+	bool written = writeFunc(fp);
+	written = (fclose(fp) == 0) && written;
+
+	if (written && ReplaceFile(tmpFile, file))
+		return true;
+
+	remove(tmpFile.c_str());
+	return false;
+}
+
+
 uint32_t FileSystemAbstraction::GetFileModificationTime(const std::string& file)
 {
 #ifdef _WIN32
@@ -392,6 +419,16 @@ bool FileSystemAbstraction::DeleteFile(const std::string& file)
 	return true;
 }
 
+bool FileSystemAbstraction::ReplaceFile(const std::string& src, const std::string& dst)
+{
+#ifdef _WIN32
+	// rename fails on Windows if dst exists
+	return (MoveFileExA(src.c_str(), dst.c_str(), MOVEFILE_REPLACE_EXISTING) != 0);
+#else
+	return (rename(src.c_str(), dst.c_str()) == 0);
+#endif
+}
+
 
 bool FileSystemAbstraction::FileExists(const std::string& file)
 {
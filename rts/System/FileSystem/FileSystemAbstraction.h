@@ -6,6 +6,8 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <cstdio>
+#include <functional>
 
 #if defined(CreateDirectory)
 	#undef CreateDirectory
@@ -28,6 +30,8 @@ public:
 	// almost direct wrappers to system calls
 	static bool MkDir(const std::string& dir);
 	static bool DeleteFile(const std::string& file);
+	/// Moves src to dst, atomically replacing dst if it exists
+	static bool ReplaceFile(const std::string& src, const std::string& dst);
 	/// Returns true if the file exists, and is not a directory
 	static bool FileExists(const std::string& file);
 	static bool DirExists(const std::string& dir);
@@ -110,6 +114,15 @@ public:
 	// custom functions
 	static bool IsReadableFile(const std::string& file);
 
+	/**
+	 * Writes a file such that concurrent readers (also in other processes)
+	 * see either the old or the complete new contents, never a partial one.
+	 * writeFunc writes to a temporary file unique to the calling process and
+	 * thread, which replaces <file> if it returns true.
+	 * @return false if the temporary file could not be written or moved
+	 */
+	static bool WriteFileAtomic(const std::string& file, const std::function<bool(FILE*)>& writeFunc);
+
 	static uint32_t GetFileModificationTime(const std::string& file);
 	/**
 	 * Returns the last file modification time formatted in a sort friendly
@@ -47,6 +47,12 @@ bool CGZFileHandler::ReadToBuffer(const std::string& path)
 	while (true) {
 		int unzippedBytes = gzread(file, unzipBuffer, BUFFER_SIZE);
 		if (unzippedBytes < 0) {
+			int errnum = Z_OK;
+
+			// file ends inside a member (eg. the demo of a crashed or running game), keep what was read
+			if (gzerror(file, &errnum) != nullptr && errnum == Z_BUF_ERROR && !fileBuffer.empty())
+				break;
+
 			fileBuffer.clear();
 			fileSize = -1;
 			gzclose(file);
@@ -86,7 +92,13 @@ bool CGZFileHandler::UncompressBuffer()
 		zstream.avail_out = BUFFER_SIZE;
 		zstream.next_out = unzipBuffer;
 		const int ret = inflate(&zstream, Z_NO_FLUSH);
-		if (ret != Z_OK) {
+
+		// input ends inside a member, keep what was inflated (as ReadToBuffer does)
+		if (ret == Z_BUF_ERROR && zstream.avail_in == 0 && !fileBuffer.empty())
+			break;
+
+		if (ret != Z_OK && ret != Z_STREAM_END) {
+			inflateEnd(&zstream);
 			fileBuffer.clear();
 			fileSize = -1;
 			return false;
@@ -95,8 +107,14 @@ bool CGZFileHandler::UncompressBuffer()
 		const size_t unzippedBytes = BUFFER_SIZE - zstream.avail_out;
 		fileBuffer.insert(fileBuffer.end(), unzipBuffer, unzipBuffer + unzippedBytes);
 
-		if (ret == Z_STREAM_END)
+		if (ret != Z_STREAM_END)
+			continue;
+
+		// concatenated members (eg. savegames) are one stream, like gzread treats them
+		if (zstream.avail_in == 0)
 			break;
+
+		inflateReset(&zstream);
 	}
 
 	inflateEnd(&zstream);
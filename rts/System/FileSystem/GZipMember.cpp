@@ -0,0 +1,52 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "GZipMember.h"
+
+#include <stdexcept>
+#include <string>
+#include <zlib.h>
+
+
+std::vector<std::uint8_t> GZipMember::Compress(const void* data, size_t size, int level)
+{
+	z_stream zstream = {};
+
+	// +16 writes a gzip header and trailer instead of a zlib one
+	if (deflateInit2(&zstream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		throw std::runtime_error("[GZipMember] could not initialize zlib");
+
+	std::vector<std::uint8_t> member(deflateBound(&zstream, size));
+
+	zstream.next_in   = reinterpret_cast<Bytef*>(const_cast<void*>(data));
+	zstream.avail_in  = size;
+	zstream.next_out  = member.data();
+	zstream.avail_out = member.size();
+
+	// output is large enough to finish in one call
+	const int ret = deflate(&zstream, Z_FINISH);
+
+	member.resize(zstream.total_out);
+	deflateEnd(&zstream);
+
+	if (ret != Z_STREAM_END)
+		throw std::runtime_error("[GZipMember] could not compress data (zlib error " + std::to_string(ret) + ")");
+
+	return member;
+}
+
+void GZipMember::Write(FILE* file, const std::vector<std::uint8_t>& member)
+{
+	if (fwrite(member.data(), 1, member.size(), file) != member.size())
+		throw std::runtime_error("[GZipMember] could not write data");
+}
+
+std::uint32_t GZipMember::CompressAndWrite(FILE* file, const void* data, size_t size, int level)
+{
+	if (size == 0)
+		return 0;
+
+	const std::vector<std::uint8_t> member = Compress(data, size, level);
+
+	Write(file, member);
+	return (member.size());
+}
@@ -0,0 +1,30 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef _GZIP_MEMBER_H
+#define _GZIP_MEMBER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+/**
+ * Writing of files as a series of independent gzip members. Readers treat
+ * concatenated members as one stream, so members can be compressed apart
+ * (in parallel, or as data comes in) and still be read back in one go.
+ */
+namespace GZipMember {
+	/// deflates <size> bytes at zlib <level> into one complete member
+	/// @throws std::runtime_error if zlib fails
+	std::vector<std::uint8_t> Compress(const void* data, size_t size, int level);
+
+	/// appends <member> to <file>
+	/// @throws std::runtime_error if it could not be written completely
+	void Write(FILE* file, const std::vector<std::uint8_t>& member);
+
+	/// Compress + Write, nothing is written for an empty buffer
+	/// @return size of the written member
+	std::uint32_t CompressAndWrite(FILE* file, const void* data, size_t size, int level);
+}
+
+#endif // _GZIP_MEMBER_H
@@ -1,7 +1,10 @@
 /* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
 
+#include <algorithm>
+#include <cstdio>
+#include <future>
 #include <sstream>
-#include <zlib.h>
+#include <thread>
 
 #include "ExternalAI/SkirmishAIHandler.h"
 #include "ExternalAI/EngineOutHandler.h"
@@ -44,6 +47,7 @@
 #include "System/FileSystem/DataDirsAccess.h"
 #include "System/FileSystem/FileQueryFlags.h"
 #include "System/FileSystem/GZFileHandler.h"
+#include "System/FileSystem/GZipMember.h"
 #include "System/Threading/ThreadPool.h"
 #include "System/creg/SerializeLuaState.h"
 #include "System/creg/Serializer.h"
@@ -51,6 +55,8 @@
 #include "System/Log/ILog.h"
 
 #define MAX_STRING_SIZE (1 << 19) // 512kB excluding null-term
+#define SAVE_CHUNK_SIZE (1 << 22) // 4MB of uncompressed state per gzip member
+#define SAVE_COMPRESSION_LEVEL 5
 
 
 CCregLoadSaveHandler::CCregLoadSaveHandler()
@@ -202,6 +208,65 @@ static void WriteString(std::ostream& s, const std::string& str)
 	s.write(str.c_str(), str.length() + 1);
 }
 
+/// gzip readers treat concatenated members as one stream, so the chunks can
+/// be compressed in parallel and written out in order as they complete
+static void WriteSaveFile(FILE* file, const std::string& filePath, std::string&& data)
+{
+	const size_t numChunks = std::max(size_t(1), (data.size() + SAVE_CHUNK_SIZE - 1) / SAVE_CHUNK_SIZE);
+	const size_t numThreads = std::clamp(size_t(std::thread::hardware_concurrency() / 2), size_t(1), std::min(numChunks, size_t(4)));
+
+	// a failing chunk hands its exception to the writer through the future
+	std::vector<std::packaged_task<std::vector<std::uint8_t>()>> chunkTasks;
+	std::vector<std::future<std::vector<std::uint8_t>>> chunkFutures;
+	std::vector<std::future<void>> workers;
+
+	chunkTasks.reserve(numChunks);
+	chunkFutures.reserve(numChunks);
+	workers.reserve(numThreads);
+
+	for (size_t i = 0; i < numChunks; i++) {
+		const size_t offset = i * SAVE_CHUNK_SIZE;
+		const size_t size = std::min(size_t(SAVE_CHUNK_SIZE), data.size() - offset);
+
+		chunkTasks.emplace_back([&data, offset, size]() { return GZipMember::Compress(data.data() + offset, size, SAVE_COMPRESSION_LEVEL); });
+		chunkFutures.emplace_back(chunkTasks.back().get_future());
+	}
+
+	// dedicated threads, the pool's workers belong to the sim
+	for (size_t n = 0; n < numThreads; n++) {
+		workers.emplace_back(std::async(std::launch::async, [&, n]() {
+			for (size_t i = n; i < numChunks; i += numThreads) {
+				chunkTasks[i]();
+			}
+		}));
+	}
+
+	bool written = true;
+
+	try {
+		for (auto& chunkFuture: chunkFutures) {
+			GZipMember::Write(file, chunkFuture.get());
+		}
+	} catch (const std::exception& ex) {
+		LOG_L(L_ERROR, "[LSH::%s] %s", __func__, ex.what());
+		written = false;
+	}
+
+	// tasks never throw, but still reference data until they are done
+	for (auto& worker: workers) {
+		worker.wait();
+	}
+
+	if (fclose(file) != 0 && written) {
+		LOG_L(L_ERROR, "[LSH::%s] could not write save-file", __func__);
+		written = false;
+	}
+
+	// a truncated save would only fail once it is loaded
+	if (!written)
+		std::remove(filePath.c_str());
+}
+
 static void PrintSize(const char* txt, int size)
 {
 	if (size > (1024 * 1024 * 1024)) {
@@ -265,7 +330,7 @@ void CCregLoadSaveHandler::SaveGame(const std::string& path)
 
 		// write our own header. SavePackage() will add its own
 		WriteString(oss, SpringVersion::GetSync());
-		WriteString(oss, gameSetup->setupText);
+		WriteString(oss, scriptText.empty()? gameSetup->setupText: scriptText);
 		WriteString(oss, modName);
 		WriteString(oss, mapName);
 
@@ -304,23 +369,20 @@ void CCregLoadSaveHandler::SaveGame(const std::string& path)
 		}
 
 		{
-			gzFile file = gzopen(dataDirsAccess.LocateFile(path, FileQueryFlags::WRITE).c_str(), "wb5");
+			std::string filePath = dataDirsAccess.LocateFile(path, FileQueryFlags::WRITE);
+			FILE* file = fopen(filePath.c_str(), "wb");
 
 			if (file == nullptr) {
 				LOG_L(L_ERROR, "[LSH::%s] could not open save-file", __func__);
 				return;
 			}
 
-			std::string data = oss.str();
-			std::function<void(gzFile, std::string&&)> func = [](gzFile file, std::string&& data) {
-				gzwrite(file, data.c_str(), data.size());
-				gzflush(file, Z_FINISH);
-				gzclose(file);
-			};
+			// take over the serialized state without copying it
+			std::string data = std::move(oss).str();
 
-			// gzFile is just a plain typedef (struct gzFile_s {}* gzFile), can be copied
+			// compression and disk IO run in the background, only serialization has to be synced
 			// need to keep a reference to the future around or its destructor will block
-			ThreadPool::AddExtJob(std::move(std::async(std::launch::async, std::move(func), file, std::move(data))));
+			ThreadPool::AddExtJob(std::move(std::async(std::launch::async, WriteSaveFile, file, std::move(filePath), std::move(data))));
 		}
 
 		//FIXME add lua state
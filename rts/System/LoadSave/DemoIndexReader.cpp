@@ -0,0 +1,150 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "DemoIndexReader.h"
+
+#include "System/FileSystem/FileHandler.h"
+#include "System/FileSystem/VFSModes.h"
+#include "System/Log/ILog.h"
+
+#include <cstring>
+#include <zlib.h>
+
+// gzip header, stored block header and gzip trailer around uncompressed members
+static constexpr std::uint32_t STORED_MEMBER_HEAD = 10 + 5;
+static constexpr std::uint32_t STORED_MEMBER_SIZE = STORED_MEMBER_HEAD + 8;
+
+
+CDemoIndexReader::CDemoIndexReader(const std::string& filename): file(new CFileHandler(filename, SPRING_VFS_PWD_ALL))
+{
+	memset(&footer, 0, sizeof(footer));
+
+	if (!file->FileExists())
+		return;
+
+	valid = ReadIndex();
+}
+
+CDemoIndexReader::~CDemoIndexReader() = default;
+
+
+bool CDemoIndexReader::ReadMember(std::uint32_t fileOffset, std::uint32_t fileSize, std::vector<std::uint8_t>& data)
+{
+	data.clear();
+
+	if (fileSize == 0)
+		return true;
+	if (file->FileSize() < 0 || (std::uint64_t(fileOffset) + fileSize) > std::uint64_t(file->FileSize()))
+		return false;
+
+	std::vector<std::uint8_t> compressed(fileSize);
+
+	file->Seek(fileOffset);
+
+	if (file->Read(compressed.data(), fileSize) != int(fileSize))
+		return false;
+
+	z_stream zstream = {};
+
+	//+16 marks it's a gzip header
+	if (inflateInit2(&zstream, 15 + 16) != Z_OK)
+		return false;
+
+	zstream.next_in  = compressed.data();
+	zstream.avail_in = compressed.size();
+
+	std::uint8_t unzipBuffer[8192];
+	int ret = Z_OK;
+
+	while (ret == Z_OK) {
+		zstream.next_out  = unzipBuffer;
+		zstream.avail_out = sizeof(unzipBuffer);
+
+		ret = inflate(&zstream, Z_NO_FLUSH);
+		data.insert(data.end(), unzipBuffer, unzipBuffer + (sizeof(unzipBuffer) - zstream.avail_out));
+	}
+
+	inflateEnd(&zstream);
+	return (ret == Z_STREAM_END);
+}
+
+bool CDemoIndexReader::ReadIndex()
+{
+	std::vector<std::uint8_t> data;
+
+	if (file->FileSize() < int(sizeof(DemoIndexFooter) + STORED_MEMBER_SIZE))
+		return false;
+	if (!ReadMember(file->FileSize() - (sizeof(DemoIndexFooter) + STORED_MEMBER_SIZE), sizeof(DemoIndexFooter) + STORED_MEMBER_SIZE, data))
+		return false;
+	if (data.size() != sizeof(DemoIndexFooter))
+		return false;
+
+	memcpy(&footer, data.data(), sizeof(footer));
+	footer.swab();
+
+	if (memcmp(footer.magic, DEMOINDEX_MAGIC, sizeof(footer.magic)) != 0)
+		return false;
+
+	if (footer.version != DEMOINDEX_VERSION || footer.footerSize != sizeof(DemoIndexFooter)) {
+		LOG_L(L_WARNING, "[DemoIndexReader::%s] unsupported demo index (version %d, size %d)", __func__, footer.version, footer.footerSize);
+		return false;
+	}
+
+	if (!ReadMember(footer.indexFileOffset, footer.indexFileSize, data))
+		return false;
+	if (footer.numChunks < 0 || data.size() != (footer.numChunks * sizeof(DemoIndexChunk)))
+		return false;
+
+	chunks.resize(footer.numChunks);
+	memcpy(chunks.data(), data.data(), data.size());
+
+	for (DemoIndexChunk& chunk: chunks) {
+		chunk.swab();
+	}
+
+	return true;
+}
+
+
+bool CDemoIndexReader::ReadFileHeader(DemoFileHeader& header)
+{
+	std::vector<std::uint8_t> data;
+
+	if (!ReadMember(0, sizeof(DemoFileHeader) + STORED_MEMBER_SIZE, data) || data.size() != sizeof(DemoFileHeader))
+		return false;
+
+	memcpy(&header, data.data(), sizeof(header));
+	header.swab();
+	return true;
+}
+
+bool CDemoIndexReader::ReadStats(std::vector<std::uint8_t>& data)
+{
+	return (valid && ReadMember(footer.statsFileOffset, footer.statsFileSize, data));
+}
+
+bool CDemoIndexReader::ReadChunk(size_t chunkIdx, std::vector<std::uint8_t>& data)
+{
+	if (!valid || chunkIdx >= chunks.size())
+		return false;
+
+	return (ReadMember(chunks[chunkIdx].fileOffset, chunks[chunkIdx].fileSize, data) && data.size() == chunks[chunkIdx].streamSize);
+}
+
+
+std::vector<size_t> CDemoIndexReader::FindChunks(int minFrame, int maxFrame, int packetType) const
+{
+	std::vector<size_t> chunkIndices;
+
+	for (size_t i = 0; i < chunks.size(); i++) {
+		const DemoIndexChunk& chunk = chunks[i];
+
+		if (chunk.firstFrame < 0 || chunk.lastFrame < minFrame || chunk.firstFrame > maxFrame)
+			continue;
+		if (packetType >= 0 && !chunk.HasPacketType(packetType))
+			continue;
+
+		chunkIndices.push_back(i);
+	}
+
+	return chunkIndices;
+}
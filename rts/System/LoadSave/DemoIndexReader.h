@@ -0,0 +1,56 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef DEMO_INDEX_READER
+#define DEMO_INDEX_READER
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "demofile.h"
+
+class CFileHandler;
+
+/**
+ * @brief Random access to indexed demofiles
+ *
+ * Reads the index appended to demos of finished games and inflates single
+ * members of the file, so tools can get at the header, statistics or a range
+ * of frames without decompressing the whole demo. Members are independent,
+ * separate readers may decode different chunks in parallel.
+ */
+class CDemoIndexReader
+{
+public:
+	CDemoIndexReader(const std::string& filename);
+	~CDemoIndexReader();
+
+	/// @return false if the file does not exist or has no (valid) index
+	bool IsValid() const { return valid; }
+
+	const DemoIndexFooter& GetFooter() const { return footer; }
+	const std::vector<DemoIndexChunk>& GetChunks() const { return chunks; }
+
+	bool ReadFileHeader(DemoFileHeader& header);
+	/// raw statistics data, laid out as after the demo stream
+	bool ReadStats(std::vector<std::uint8_t>& data);
+	/// uncompressed startscript and/or demo stream data of <chunkIdx>
+	bool ReadChunk(size_t chunkIdx, std::vector<std::uint8_t>& data);
+
+	/// indices of the chunks with packets in [minFrame, maxFrame] (and of <packetType> if not negative)
+	std::vector<size_t> FindChunks(int minFrame, int maxFrame, int packetType = -1) const;
+
+private:
+	bool ReadIndex();
+	bool ReadMember(std::uint32_t fileOffset, std::uint32_t fileSize, std::vector<std::uint8_t>& data);
+
+private:
+	std::unique_ptr<CFileHandler> file;
+
+	DemoIndexFooter footer;
+	std::vector<DemoIndexChunk> chunks;
+
+	bool valid = false;
+};
+
+#endif
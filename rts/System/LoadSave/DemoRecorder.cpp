@@ -4,10 +4,13 @@
 #include <cerrno>
 #include <cstring>
 #include <memory>
+#include <stdexcept>
+#include <zlib.h>
 
 #include "DemoRecorder.h"
 #include "base64.h"
 #include "Game/GameVersion.h"
+#include "Net/Protocol/NetMessageTypes.h"
 #include "Sim/Misc/TeamStatistics.h"
 #include "System/TimeUtil.h"
 #include "System/StringUtil.h"
@@ -15,6 +18,7 @@
 #include "System/FileSystem/FileSystem.h"
 #include "System/FileSystem/FileQueryFlags.h"
 #include "System/FileSystem/FileHandler.h"
+#include "System/FileSystem/GZipMember.h"
 #include "System/Log/ILog.h"
 #include "System/Threading/ThreadPool.h"
 
@@ -27,21 +31,77 @@
 #endif
 
 
-// server and client memory-streams
-static std::string demoStreams[2];
-static spring::mutex demoMutex;
+// demo data is streamed to disk as a series of independently compressed gzip
+// members, each holding at most DEMO_CHUNK_SIZE bytes or DEMO_CHUNK_TIME game
+// seconds of data; this bounds memory use and keeps demos of crashed or still
+// running games readable up to their last complete member
+static constexpr size_t DEMO_CHUNK_SIZE = 256 * 1024;
+static constexpr float DEMO_CHUNK_TIME = 10.0f;
+static constexpr int DEMO_COMPRESSION_LEVEL = 5;
 
 
-CDemoRecorder::CDemoRecorder(const std::string& mapName, const std::string& modName, bool serverDemo): isServerDemo(serverDemo)
+/// @return size of the written member
+static std::uint32_t WriteDemoChunk(FILE* file, const char* data, size_t size, int level = DEMO_COMPRESSION_LEVEL)
 {
-	std::lock_guard<spring::mutex> lock(demoMutex);
+	const std::uint32_t chunkSize = GZipMember::CompressAndWrite(file, data, size, level);
+
+	// make the member visible to anyone reading the demo of a running game
+	if (chunkSize > 0 && fflush(file) != 0)
+		throw std::runtime_error("[DemoRecorder] could not write demo chunk");
+
+	return chunkSize;
+}
+
 
-	SetStream();
+/// appends the statistics, index and footer members, then rewrites the header member
+static void WriteDemoFooter(
+	FILE* file,
+	const std::string& data,
+	std::vector<DemoIndexChunk>& index,
+	std::uint32_t fileOffset,
+	const std::vector<std::uint8_t>& header
+) {
+	DemoIndexFooter footer;
+	memset(&footer, 0, sizeof(footer));
+	strcpy(footer.magic, DEMOINDEX_MAGIC);
+	footer.version = DEMOINDEX_VERSION;
+	footer.footerSize = sizeof(DemoIndexFooter);
+	footer.numChunks = index.size();
+
+	footer.statsFileOffset = fileOffset;
+	footer.statsFileSize = WriteDemoChunk(file, data.data(), data.size());
+	footer.indexFileOffset = footer.statsFileOffset + footer.statsFileSize;
+
+	for (DemoIndexChunk& chunk: index) {
+		chunk.swab();
+	}
+
+	footer.indexFileSize = WriteDemoChunk(file, reinterpret_cast<const char*>(index.data()), index.size() * sizeof(DemoIndexChunk));
+	footer.swab();
+
+	WriteDemoChunk(file, reinterpret_cast<const char*>(&footer), sizeof(footer), Z_NO_COMPRESSION);
+
+	fseek(file, 0, SEEK_SET);
+	GZipMember::Write(file, header);
+}
+
+
+CDemoRecorder::CDemoRecorder(const std::string& mapName, const std::string& modName, bool serverDemo): isServerDemo(serverDemo)
+{
 	SetName(mapName, modName);
 	SetFileHeader();
+
+	if ((file = fopen(demoName.c_str(), "wb")) == nullptr) {
+		LOG_L(L_ERROR, "[DemoRecorder::%s] could not open \"%s\" for writing (%s)", __func__, demoName.c_str(), strerror(errno));
+		return;
+	}
+
+	chunkBuffer.reserve(DEMO_CHUNK_SIZE);
 	WriteFileHeader(false);
 
-	file = gzopen(demoName.c_str(), "wb9");
+	indexChunk.streamOffset = sizeof(DemoFileHeader);
+	indexChunk.firstFrame = -1;
+	nextFileOffset = headerChunkSize;
 }
 
 CDemoRecorder::~CDemoRecorder()
@@ -49,20 +109,15 @@ CDemoRecorder::~CDemoRecorder()
 	if (file == nullptr)
 		return;
 
+	// statistics go into their own member, after the last indexed chunk
+	WriteChunk();
 	WriteWinnerList();
 	WritePlayerStats();
 	WriteTeamStats();
-	WriteFileHeader(true);
 	WriteDemoFile();
 }
 
 
-void CDemoRecorder::SetStream()
-{
-	demoStreams[isServerDemo].clear();
-	demoStreams[isServerDemo].reserve(8 * 1024 * 1024);
-}
-
 void CDemoRecorder::SetFileHeader()
 {
 	memset(&fileHeader, 0, sizeof(DemoFileHeader));
@@ -77,31 +132,99 @@ void CDemoRecorder::SetFileHeader()
 	fileHeader.winningAllyTeamsSize = 0;
 }
 
+void CDemoRecorder::WriteChunk()
+{
+	if (file == nullptr) {
+		chunkBuffer.clear();
+		return;
+	}
+
+	if (chunkBuffer.empty())
+		return;
+
+	// at most one chunk is in flight, the next waits for it to keep member order
+	FinishChunkWrite();
+
+	if (file == nullptr) {
+		chunkBuffer.clear();
+		return;
+	}
+
+	indexChunk.fileOffset = nextFileOffset;
+	indexChunk.streamSize = chunkBuffer.size();
+	demoIndex.push_back(indexChunk);
+
+	chunkWrite = std::async(std::launch::async, [file = file, data = std::move(chunkBuffer)]() {
+		return (WriteDemoChunk(file, data.data(), data.size()));
+	});
+
+	memset(&indexChunk.packetTypes[0], 0, sizeof(indexChunk.packetTypes));
+	indexChunk.streamOffset += indexChunk.streamSize;
+	indexChunk.firstFrame = -1;
+
+	chunkBuffer.clear();
+	chunkBuffer.reserve(DEMO_CHUNK_SIZE);
+}
+
+void CDemoRecorder::FinishChunkWrite()
+{
+	if (!chunkWrite.valid())
+		return;
+
+	try {
+		demoIndex.back().fileSize = chunkWrite.get();
+		nextFileOffset += demoIndex.back().fileSize;
+	} catch (const std::exception& ex) {
+		StopWriting(ex.what());
+	}
+}
+
+void CDemoRecorder::StopWriting(const char* reason)
+{
+	LOG_L(L_ERROR, "[DemoRecorder::%s] stopped recording \"%s\" (%s), the demo is incomplete", __func__, demoName.c_str(), reason);
+
+	fclose(file);
+	file = nullptr;
+}
+
 void CDemoRecorder::WriteDemoFile()
 {
-	// zlib FAQ claims the lib is thread-safe, "however any library routines that zlib uses and
-	// any application-provided memory allocation routines must also be thread-safe. zlib's gz*
-	// functions use stdio library routines, and most of zlib's functions use the library memory
-	// allocation routines by default" (so code below should be OK)
-	// gz* should usually be finished before ctor runs again when reloading, but take no chances
-	std::string& data = demoStreams[isServerDemo];
-	std::function<void(gzFile, std::string&)> func = [](gzFile file, std::string& data) {
-		std::lock_guard<spring::mutex> lock(demoMutex);
-
-		gzwrite(file, data.c_str(), data.size());
-		gzflush(file, Z_FINISH);
-		gzclose(file);
+	// a failed chunk write already stopped the recording
+	if (file == nullptr)
+		return;
+
+	// the statistics, index and final header are written by an external job,
+	// workers are already gone and the caller should not block
+	std::vector<std::uint8_t> headerChunk = GetFileHeaderChunk(true);
+
+	auto func = [
+		file = file,
+		name = demoName,
+		data = std::move(chunkBuffer),
+		prevWrite = std::move(chunkWrite),
+		index = std::move(demoIndex),
+		fileOffset = nextFileOffset,
+		header = std::move(headerChunk)
+	]() mutable {
+		try {
+			if (prevWrite.valid()) {
+				index.back().fileSize = prevWrite.get();
+				fileOffset += index.back().fileSize;
+			}
+
+			WriteDemoFooter(file, data, index, fileOffset, header);
+		} catch (const std::exception& ex) {
+			LOG_L(L_ERROR, "[DemoRecorder::WriteDemoFile] could not finish \"%s\" (%s), the demo is incomplete", name.c_str(), ex.what());
+		}
+
+		if (fclose(file) != 0)
+			LOG_L(L_ERROR, "[DemoRecorder::WriteDemoFile] could not finish \"%s\" (%s)", name.c_str(), strerror(errno));
 	};
 
-	LOG("[DemoRecorder::%s] writing %s-demo \"%s\" (" _STPF_ " bytes)", __func__, (isServerDemo? "server": "client"), demoName.c_str(), data.size());
+	LOG("[DemoRecorder::%s] writing %s-demo \"%s\" (%d bytes)", __func__, (isServerDemo? "server": "client"), demoName.c_str(), fileHeader.demoStreamSize);
 
-	#ifndef _WIN32
-	// NOTE: can not use ThreadPool for this directly here, workers are already gone
-	// FIXME: does not currently (august 2017) compile on Windows mingw buildbots
-	ThreadPool::AddExtJob(spring::thread(std::move(func), file, std::ref(data)));
-	#else
-	ThreadPool::AddExtJob(std::move(std::async(std::launch::async, std::move(func), file, std::ref(data))));
-	#endif
+	ThreadPool::AddExtJob(std::async(std::launch::async, std::move(func)));
+	file = nullptr;
 }
 
 void CDemoRecorder::WriteSetupText(const std::string& text)
@@ -120,7 +243,7 @@ void CDemoRecorder::WriteSetupText(const std::string& text)
 	}
 
 	fileHeader.scriptSize = length;
-	demoStreams[isServerDemo].append(text.c_str(), length);
+	chunkBuffer.append(text.c_str(), length);
 }
 
 void CDemoRecorder::SaveToDemo(const unsigned char* buf, const unsigned length, const float modGameTime)
@@ -130,9 +253,35 @@ void CDemoRecorder::SaveToDemo(const unsigned char* buf, const unsigned length,
 	chunkHeader.modGameTime = modGameTime;
 	chunkHeader.length = length;
 	chunkHeader.swab();
-	demoStreams[isServerDemo].append(reinterpret_cast<const char*>(&chunkHeader), sizeof(chunkHeader));
-	demoStreams[isServerDemo].append(reinterpret_cast<const char*>(buf), length);
+	chunkBuffer.append(reinterpret_cast<const char*>(&chunkHeader), sizeof(chunkHeader));
+	chunkBuffer.append(reinterpret_cast<const char*>(buf), length);
 	fileHeader.demoStreamSize += (length + sizeof(chunkHeader));
+
+	if (length > 0) {
+		switch (buf[0]) {
+			case NETMSG_KEYFRAME: {
+				if (length >= (sizeof(std::uint8_t) + sizeof(std::int32_t)))
+					memcpy(&demoFrameNum, &buf[1], sizeof(std::int32_t));
+			} break;
+			case NETMSG_NEWFRAME: {
+				demoFrameNum += 1;
+			} break;
+			default: {
+			} break;
+		}
+
+		if (indexChunk.firstFrame < 0)
+			indexChunk.firstFrame = demoFrameNum;
+
+		indexChunk.lastFrame = demoFrameNum;
+		indexChunk.AddPacketType(buf[0]);
+	}
+
+	if (chunkBuffer.size() < DEMO_CHUNK_SIZE && (modGameTime - chunkStartTime) < DEMO_CHUNK_TIME)
+		return;
+
+	chunkStartTime = modGameTime;
+	WriteChunk();
 }
 
 void CDemoRecorder::SetName(const std::string& mapName, const std::string& modName)
@@ -173,7 +322,9 @@ void CDemoRecorder::SetName(const std::string& mapName, const std::string& modNa
 void CDemoRecorder::SetGameID(const unsigned char* buf)
 {
 	memcpy(&fileHeader.gameID, buf, sizeof(fileHeader.gameID));
-	WriteFileHeader(false);
+
+	if (file != nullptr)
+		WriteFileHeader(false);
 }
 
 void CDemoRecorder::SetTime(int gameTime, int wallclockTime)
@@ -228,10 +379,10 @@ void CDemoRecorder::SetWinningAllyTeams(const std::vector<unsigned char>& winnin
 	winningAllyTeams = winningAllyTeamIDs;
 }
 
-/** @brief Write DemoFileHeader
-Write the DemoFileHeader at the start of the file and restores the original
-position in the file afterwards. */
-unsigned int CDemoRecorder::WriteFileHeader(bool updateStreamLength)
+/** @brief Compress the DemoFileHeader
+The header is stored uncompressed in its own gzip member, which gives the member
+a fixed size so it can be overwritten at the start of the file later on. */
+std::vector<std::uint8_t> CDemoRecorder::GetFileHeaderChunk(bool updateStreamLength) const
 {
 	DemoFileHeader tmpHeader;
 	memcpy(&tmpHeader, &fileHeader, sizeof(fileHeader));
@@ -242,28 +393,47 @@ unsigned int CDemoRecorder::WriteFileHeader(bool updateStreamLength)
 	// to little endian
 	tmpHeader.swab();
 
-	if (demoStreams[isServerDemo].empty()) {
-		demoStreams[isServerDemo].append(reinterpret_cast<const char*>(&tmpHeader), sizeof(tmpHeader));
-	} else {
-		assert(demoStreams[isServerDemo].size() >= sizeof(tmpHeader));
-		memcpy(&demoStreams[isServerDemo][0], reinterpret_cast<const char*>(&tmpHeader), sizeof(tmpHeader)); // no non-const .data() until C++17
-	}
+	return (GZipMember::Compress(&tmpHeader, sizeof(tmpHeader), Z_NO_COMPRESSION));
+}
+
+/** @brief Write DemoFileHeader
+Overwrite the DemoFileHeader member at the start of the file, then continue
+appending at the end. */
+void CDemoRecorder::WriteFileHeader(bool updateStreamLength)
+{
+	const std::vector<std::uint8_t> headerChunk = GetFileHeaderChunk(updateStreamLength);
+
+	if (headerChunkSize == 0)
+		headerChunkSize = headerChunk.size();
+
+	assert(headerChunk.size() == headerChunkSize);
+
+	// no chunk may be written while the header is; this blocks the caller
+	// (the sim or server thread through SetGameID, once per game) until the
+	// chunk in flight, at most DEMO_CHUNK_SIZE bytes, is compressed
+	FinishChunkWrite();
+
+	if (file == nullptr)
+		return;
+
+	fseek(file, 0, SEEK_SET);
 
-	return (demoStreams[isServerDemo].size());
+	if (fwrite(headerChunk.data(), 1, headerChunk.size(), file) != headerChunk.size() || fseek(file, 0, SEEK_END) != 0 || fflush(file) != 0)
+		StopWriting("could not write header");
 }
 
 /** @brief Write the CPlayer::Statistics at the current position in the file. */
 void CDemoRecorder::WritePlayerStats()
 {
-	const size_t pos = demoStreams[isServerDemo].size();
+	const size_t pos = chunkBuffer.size();
 
 	for (PlayerStatistics& stats: playerStats) {
 		stats.swab();
-		demoStreams[isServerDemo].append(reinterpret_cast<const char*>(&stats), sizeof(PlayerStatistics));
+		chunkBuffer.append(reinterpret_cast<const char*>(&stats), sizeof(PlayerStatistics));
 	}
 
 	fileHeader.numPlayers = playerStats.size();
-	fileHeader.playerStatSize = int(demoStreams[isServerDemo].size() - pos);
+	fileHeader.playerStatSize = int(chunkBuffer.size() - pos);
 
 	playerStats.clear();
 }
@@ -276,38 +446,38 @@ void CDemoRecorder::WriteWinnerList()
 	if (fileHeader.numTeams == 0)
 		return;
 
-	const size_t pos = demoStreams[isServerDemo].size();
+	const size_t pos = chunkBuffer.size();
 
 	// Write the array of winningAllyTeams.
 	for (size_t i = 0; i < winningAllyTeams.size(); i++) { // NOLINT{modernize-loop-convert}
-		demoStreams[isServerDemo].append(reinterpret_cast<const char*>(&winningAllyTeams[i]), sizeof(unsigned char));
+		chunkBuffer.append(reinterpret_cast<const char*>(&winningAllyTeams[i]), sizeof(unsigned char));
 	}
 
 	winningAllyTeams.clear();
 
-	fileHeader.winningAllyTeamsSize = int(demoStreams[isServerDemo].size() - pos);
+	fileHeader.winningAllyTeamsSize = int(chunkBuffer.size() - pos);
 }
 
 /** @brief Write the TeamStatistics at the current position in the file. */
 void CDemoRecorder::WriteTeamStats()
 {
-	const size_t pos = demoStreams[isServerDemo].size();
+	const size_t pos = chunkBuffer.size();
 
 	// Write array of dwords indicating number of TeamStatistics per team.
 	for (std::vector<TeamStatistics>& history: teamStats) {
 		unsigned int c = swabDWord(history.size());
-		demoStreams[isServerDemo].append(reinterpret_cast<const char*>(&c), sizeof(unsigned int));
+		chunkBuffer.append(reinterpret_cast<const char*>(&c), sizeof(unsigned int));
 	}
 
 	// Write big array of TeamStatistics.
 	for (std::vector<TeamStatistics>& history: teamStats) {
 		for (TeamStatistics& stats: history) {
 			stats.swab();
-			demoStreams[isServerDemo].append(reinterpret_cast<const char*>(&stats), sizeof(TeamStatistics));
+			chunkBuffer.append(reinterpret_cast<const char*>(&stats), sizeof(TeamStatistics));
 		}
 	}
 
-	fileHeader.teamStatSize = int(demoStreams[isServerDemo].size() - pos);
+	fileHeader.teamStatSize = int(chunkBuffer.size() - pos);
 
 	teamStats.clear();
 }
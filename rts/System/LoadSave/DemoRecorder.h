@@ -3,9 +3,10 @@
 #ifndef DEMO_RECORDER
 #define DEMO_RECORDER
 
+#include <cstdio>
+#include <future>
 #include <vector>
 #include <sstream>
-#include <zlib.h>
 
 #include "Demo.h"
 #include "Game/Players/PlayerStatistics.h"
@@ -33,6 +34,15 @@ public:
 		memset(&r.fileHeader, 0, sizeof(fileHeader));
 
 		std::swap(file, r.file);
+		std::swap(chunkBuffer, r.chunkBuffer);
+		std::swap(chunkWrite, r.chunkWrite);
+		std::swap(chunkStartTime, r.chunkStartTime);
+		std::swap(headerChunkSize, r.headerChunkSize);
+
+		std::swap(demoIndex, r.demoIndex);
+		std::swap(indexChunk, r.indexChunk);
+		std::swap(nextFileOffset, r.nextFileOffset);
+		std::swap(demoFrameNum, r.demoFrameNum);
 
 		std::swap(demoName, r.demoName);
 		std::swap(playerStats, r.playerStats);
@@ -49,7 +59,6 @@ public:
 	void WriteSetupText(const std::string& text);
 	void SaveToDemo(const unsigned char* buf, const unsigned length, const float modGameTime);
 
-	void SetStream();
 	void SetName(const std::string& mapName, const std::string& modName);
 	const std::string& GetName() const { return demoName; }
 
@@ -63,7 +72,11 @@ public:
 	void SetWinningAllyTeams(const std::vector<unsigned char>& winningAllyTeams);
 
 private:
-	unsigned int WriteFileHeader(bool updateStreamLength);
+	std::vector<std::uint8_t> GetFileHeaderChunk(bool updateStreamLength) const;
+	void WriteFileHeader(bool updateStreamLength);
+	void WriteChunk();
+	void FinishChunkWrite();
+	void StopWriting(const char* reason);
 	void SetFileHeader();
 	void WritePlayerStats();
 	void WriteTeamStats();
@@ -71,7 +84,21 @@ private:
 	void WriteDemoFile();
 
 private:
-	gzFile file = nullptr;
+	FILE* file = nullptr;
+
+	// stream data not yet handed to the writer, and the write of the previous chunk
+	std::string chunkBuffer;
+	std::future<std::uint32_t> chunkWrite;
+
+	float chunkStartTime = 0.0f;
+	size_t headerChunkSize = 0;
+
+	// entries of written chunks, and the one being filled by chunkBuffer
+	std::vector<DemoIndexChunk> demoIndex;
+	DemoIndexChunk indexChunk = {};
+
+	std::uint32_t nextFileOffset = 0;
+	int demoFrameNum = 0;
 
 	std::vector<PlayerStatistics> playerStats;
 	std::vector< std::vector<TeamStatistics> > teamStats;
@@ -4,8 +4,12 @@
 #include "CregLoadSaveHandler.h"
 #include "LuaLoadSaveHandler.h"
 #include "Game/GameSetup.h"
+#include "Sim/Misc/GlobalSynced.h"
 #include "System/FileSystem/FileSystem.h"
 #include "System/Log/ILog.h"
+#include "System/TdfParser.h"
+
+#include <sstream>
 
 SaveFileData globalSaveFileData;
 
@@ -24,9 +28,26 @@ ILoadSaveHandler* ILoadSaveHandler::CreateHandler(const std::string& saveFile)
 }
 
 
+/// the demo's setup-script, telling the server which frame the save resumes from
+static std::string GetDemoKeyFrameScript()
+{
+	TdfParser script(gameSetup->setupText.c_str(), gameSetup->setupText.size());
+	TdfParser::TdfSection* tgame = script.GetRootSection()->sections["game"];
+
+	std::ostringstream keyFrameScript;
+
+	tgame->remove("DemoStartFrame", false);
+	tgame->AddPair("DemoStartFrame", gs->frameNum);
+
+	script.print(keyFrameScript);
+	return (keyFrameScript.str());
+}
+
+
 bool ILoadSaveHandler::CreateSave(
 	const std::string& saveFile,
-	const std::string& saveArgs
+	const std::string& saveArgs,
+	bool demoKeyFrame
 ) {
 	if (!FileSystem::CreateDirectory("Saves"))
 		return false;
@@ -39,6 +60,10 @@ bool ILoadSaveHandler::CreateSave(
 	ILoadSaveHandler* ls = CreateHandler(saveFile);
 
 	ls->SaveInfo(gameSetup->mapName, gameSetup->mapName);
+
+	if (demoKeyFrame)
+		ls->SaveScript(GetDemoKeyFrameScript());
+
 	ls->SaveGame(saveFile);
 	LOG("[ILoadSaveHandler::%s] saved game to file \"%s\"", __func__, saveFile.c_str());
 	delete ls;
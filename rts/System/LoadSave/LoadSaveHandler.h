@@ -9,6 +9,8 @@
 struct SaveFileData {
 	std::string name; // "saves/quicksave.ssf"
 	std::string args; // "-y"
+
+	bool demoKeyFrame = false; // resumes the watched demo when loaded
 };
 
 class ILoadSaveHandler
@@ -16,12 +18,12 @@ class ILoadSaveHandler
 public:
 	static ILoadSaveHandler* CreateHandler(const std::string& saveFile);
 
-	static bool CreateSave(const std::string& saveFile, const std::string& saveArgs);
+	static bool CreateSave(const std::string& saveFile, const std::string& saveArgs, bool demoKeyFrame = false);
 	static bool CreateSave(SaveFileData fileData) {
 		if (fileData.name.empty())
 			return false;
 
-		return (CreateSave(fileData.name, fileData.args));
+		return (CreateSave(fileData.name, fileData.args, fileData.demoKeyFrame));
 	}
 
 protected:
@@ -40,6 +42,8 @@ public:
 		mapName = _mapName;
 		modName = _modName;
 	}
+	/// overrides the game's setup-script written to the save
+	void SaveScript(const std::string& _scriptText) { scriptText = _scriptText; }
 
 	const std::string& GetScriptText() const { return scriptText; }
 
@@ -115,8 +115,8 @@ void CLuaLoadSaveHandler::SaveEventClients()
 
 void CLuaLoadSaveHandler::SaveGameStartInfo()
 {
-	const std::string scriptText = gameSetup->setupText;
-	SaveEntireFile(FILE_STARTSCRIPT, "game setup", scriptText.data(), scriptText.size());
+	const std::string& startScript = scriptText.empty()? gameSetup->setupText: scriptText;
+	SaveEntireFile(FILE_STARTSCRIPT, "game setup", startScript.data(), startScript.size());
 }
 
 
@@ -23,6 +23,12 @@
  */
 #define DEMOFILE_VERSION 5
 
+/** The first 16 bytes of the DemoIndexFooter. */
+#define DEMOINDEX_MAGIC "spring demoindx"
+
+/** The current demo index version. */
+#define DEMOINDEX_VERSION 1
+
 #pragma pack(push, 1)
 
 /**
@@ -115,6 +121,76 @@ struct DemoStreamChunkHeader
 	}
 };
 
+/**
+ * @brief Spring demo index chunk entry
+ *
+ * Demo files are written as a sequence of gzip members, each of which can be
+ * inflated on its own: the DemoFileHeader (stored uncompressed), the startscript
+ * and demo stream in chunks of whole packets, the statistics, the index and the
+ * DemoIndexFooter (stored uncompressed). Demos of games that ended normally
+ * append the index after the team statistics:
+ *
+ * - Array of numChunks DemoIndexChunk's, one per startscript/demo stream member
+ * - DemoIndexFooter
+ *
+ * This is an optional extension, readers unaware of it stop after the team
+ * statistics. Demos without it (older or crashed) can only be read sequentially.
+ */
+struct DemoIndexChunk
+{
+	std::uint32_t fileOffset;     ///< Offset of the gzip member in the (compressed) demofile.
+	std::uint32_t fileSize;       ///< Compressed size of the gzip member.
+	std::uint32_t streamOffset;   ///< Offset of the member's data in the uncompressed demofile.
+	std::uint32_t streamSize;     ///< Uncompressed size of the member's data.
+	int firstFrame;               ///< Frame number at the first packet in this chunk.
+	int lastFrame;                ///< Frame number at the last packet in this chunk.
+	std::uint8_t packetTypes[32]; ///< Bit N is set if the chunk contains a packet of type N.
+
+	bool HasPacketType(unsigned int type) const { return ((packetTypes[(type >> 3) & 31] & (1 << (type & 7))) != 0); }
+	void AddPacketType(unsigned int type) { packetTypes[(type >> 3) & 31] |= (1 << (type & 7)); }
+
+	/// Change structure from host endian to little endian or vice versa.
+	void swab() {
+		swabDWordInPlace(fileOffset);
+		swabDWordInPlace(fileSize);
+		swabDWordInPlace(streamOffset);
+		swabDWordInPlace(streamSize);
+		swabDWordInPlace(firstFrame);
+		swabDWordInPlace(lastFrame);
+	}
+};
+
+/**
+ * @brief Spring demo index footer
+ *
+ * Always the last gzip member of an indexed demofile, stored uncompressed so
+ * that it can be read from the end of the file without inflating anything:
+ * the member is 10 bytes gzip header, 5 bytes block header, the footer and an
+ * 8 byte gzip trailer.
+ */
+struct DemoIndexFooter
+{
+	char magic[16];               ///< DEMOINDEX_MAGIC
+	int version;                  ///< DEMOINDEX_VERSION
+	int footerSize;               ///< Size of the DemoIndexFooter, minor version number.
+	int numChunks;                ///< Number of DemoIndexChunk's in the index.
+	std::uint32_t statsFileOffset; ///< Offset of the gzip member holding all statistics.
+	std::uint32_t statsFileSize;   ///< Compressed size of the statistics member.
+	std::uint32_t indexFileOffset; ///< Offset of the gzip member holding the DemoIndexChunk array.
+	std::uint32_t indexFileSize;   ///< Compressed size of the index member.
+
+	/// Change structure from host endian to little endian or vice versa.
+	void swab() {
+		swabDWordInPlace(version);
+		swabDWordInPlace(footerSize);
+		swabDWordInPlace(numChunks);
+		swabDWordInPlace(statsFileOffset);
+		swabDWordInPlace(statsFileSize);
+		swabDWordInPlace(indexFileOffset);
+		swabDWordInPlace(indexFileSize);
+	}
+};
+
 #pragma pack(pop)
 
 #endif // DEMO_FILE_H
@@ -10,9 +10,15 @@
 
 #include <cassert>
 #include <cstdio>
+#include <cstring>
 #include <string>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 
@@ -48,6 +54,172 @@ namespace log_file {
 		int flushLevel;
 	};
 
+	/**
+	 * Bounded lock-free multi-producer single-consumer queue of formatted
+	 * records, after D. Vyukov's bounded MPMC queue. A record takes one or
+	 * more consecutive slots which producers claim with a single CAS; the
+	 * first slot is published last, so the consumer only has to check it.
+	 */
+	struct AsyncRecordQueue {
+	public:
+		static constexpr size_t NUM_SLOTS = 4096;
+		static constexpr size_t SLOT_SIZE = 256;
+		static constexpr size_t SLOT_MASK = NUM_SLOTS - 1;
+
+		struct RecordHeader {
+			uint32_t numSlots;
+			uint32_t sectionLength;
+			uint32_t textLength;
+			int32_t level;
+		};
+
+		AsyncRecordQueue() {
+			for (size_t i = 0; i < NUM_SLOTS; i++) {
+				slots[i].seq.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		// returns false if the queue is full
+		bool TryPush(int level, const char* section, const char* prefix, const char* record) {
+			const size_t sectionLength = strlen(section);
+			const size_t prefixLength = strlen(prefix);
+			const size_t recordLength = strlen(record);
+
+			const size_t numBytes = sizeof(RecordHeader) + sectionLength + 1 + prefixLength + recordLength + 1;
+			const size_t numSlots = (numBytes + SLOT_SIZE - 1) / SLOT_SIZE;
+
+			assert(numSlots <= NUM_SLOTS);
+
+			uint64_t pos = enqueuePos.load(std::memory_order_relaxed);
+
+			for (;;) {
+				// slots are released in order, so if the last one is free all others are
+				const uint64_t lastPos = pos + numSlots - 1;
+				const uint64_t seq = slots[lastPos & SLOT_MASK].seq.load(std::memory_order_acquire);
+				const int64_t diff = static_cast<int64_t>(seq - lastPos);
+
+				if (diff < 0)
+					return false;
+
+				if (diff > 0) {
+					pos = enqueuePos.load(std::memory_order_relaxed);
+					continue;
+				}
+
+				if (enqueuePos.compare_exchange_weak(pos, pos + numSlots, std::memory_order_relaxed))
+					break;
+			}
+
+			const RecordHeader header = {uint32_t(numSlots), uint32_t(sectionLength), uint32_t(prefixLength + recordLength), level};
+
+			size_t offset = 0;
+			offset = CopyIn(pos, offset, &header, sizeof(header));
+			offset = CopyIn(pos, offset, section, sectionLength + 1);
+			offset = CopyIn(pos, offset, prefix, prefixLength);
+			offset = CopyIn(pos, offset, record, recordLength + 1);
+
+			for (size_t k = numSlots - 1; k > 0; k--) {
+				slots[(pos + k) & SLOT_MASK].seq.store(pos + k + 1, std::memory_order_release);
+			}
+
+			slots[pos & SLOT_MASK].seq.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+
+		// single consumer only; stops at the first record not yet published
+		bool TryPop(RecordHeader& header, std::vector<char>& buffer) {
+			const uint64_t pos = dequeuePos.load(std::memory_order_relaxed);
+			const uint64_t seq = slots[pos & SLOT_MASK].seq.load(std::memory_order_acquire);
+
+			if (seq != (pos + 1))
+				return false;
+
+			size_t offset = CopyOut(pos, 0, &header, sizeof(header));
+
+			// section, then prefixed text; both null-terminated
+			buffer.resize(header.sectionLength + 1 + header.textLength + 1);
+			CopyOut(pos, offset, buffer.data(), buffer.size());
+
+			for (size_t k = 0; k < header.numSlots; k++) {
+				slots[(pos + k) & SLOT_MASK].seq.store(pos + k + NUM_SLOTS, std::memory_order_release);
+			}
+
+			dequeuePos.store(pos + header.numSlots, std::memory_order_relaxed);
+			return true;
+		}
+
+	private:
+		size_t CopyIn(uint64_t pos, size_t offset, const void* src, size_t size) {
+			const char* bytes = reinterpret_cast<const char*>(src);
+
+			while (size > 0) {
+				const size_t slotOffset = offset % SLOT_SIZE;
+				const size_t numBytes = std::min(size, SLOT_SIZE - slotOffset);
+
+				memcpy(&slots[(pos + offset / SLOT_SIZE) & SLOT_MASK].data[slotOffset], bytes, numBytes);
+
+				bytes += numBytes;
+				offset += numBytes;
+				size -= numBytes;
+			}
+
+			return offset;
+		}
+
+		size_t CopyOut(uint64_t pos, size_t offset, void* dst, size_t size) const {
+			char* bytes = reinterpret_cast<char*>(dst);
+
+			while (size > 0) {
+				const size_t slotOffset = offset % SLOT_SIZE;
+				const size_t numBytes = std::min(size, SLOT_SIZE - slotOffset);
+
+				memcpy(bytes, &slots[(pos + offset / SLOT_SIZE) & SLOT_MASK].data[slotOffset], numBytes);
+
+				bytes += numBytes;
+				offset += numBytes;
+				size -= numBytes;
+			}
+
+			return offset;
+		}
+
+	private:
+		struct Slot {
+			std::atomic<uint64_t> seq;
+			char data[SLOT_SIZE];
+		};
+
+		alignas(64) std::atomic<uint64_t> enqueuePos = {0};
+		alignas(64) std::atomic<uint64_t> dequeuePos = {0};
+
+		Slot slots[NUM_SLOTS];
+	};
+
+	/**
+	 * State of the optional writer thread which owns file output while
+	 * asynchronous writing is enabled.
+	 */
+	struct AsyncWriter {
+		std::unique_ptr<AsyncRecordQueue> queue;
+		std::vector<char> buffer;
+
+		std::thread thread;
+		// read by producers and crash-handlers on any thread
+		std::atomic<std::thread::id> threadId;
+
+		std::atomic<bool> enabled = {false};
+		std::atomic<bool> running = {false};
+
+		// producers between checking <enabled> and finishing their push
+		std::atomic<int> numPushing = {0};
+	};
+
+	/**
+	 * Guards the log-files container against the writer thread; whoever
+	 * holds it is the (only) consumer of the async record queue.
+	 */
+	std::mutex filesMutex;
+
 	/**
 	 * This is only used to check whether some code tries to access the
 	 * log-files container after it got deleted.
@@ -71,22 +243,30 @@ namespace log_file {
 		LogFilesMap& GetLogFiles() {
 			return logFiles;
 		}
+		AsyncWriter& GetAsyncWriter() {
+			return asyncWriter;
+		}
 
 	private:
 		std::vector< std::pair<std::string, LogFileDetails> > logFiles;
+
+		AsyncWriter asyncWriter;
 	};
 
 	using LogFilePair = LogFilesContainer::LogFilePair;
 	using LogFilesMap = LogFilesContainer::LogFilesMap;
 
 
-	inline LogFilesMap& getLogFiles() {
+	inline LogFilesContainer& getLogFilesContainer() {
 		static LogFilesContainer logFilesContainer;
 
 		assert(validTracker);
-		return (logFilesContainer.GetLogFiles());
+		return logFilesContainer;
 	}
 
+	inline LogFilesMap& getLogFiles() { return (getLogFilesContainer().GetLogFiles()); }
+	inline AsyncWriter& getAsyncWriter() { return (getLogFilesContainer().GetAsyncWriter()); }
+
 
 	/**
 	 * This class allows us to stop logging cleanly, when the application exits,
@@ -120,10 +300,7 @@ namespace log_file {
 		return (!getLogFiles().empty());
 	}
 
-	void writeToFile(FILE* outStream, const char* record, bool flush) {
-		char framePrefix[128] = {'\0'};
-		log_framePrefixer_createPrefix(framePrefix, sizeof(framePrefix));
-
+	void writeToFile(FILE* outStream, const char* framePrefix, const char* record, bool flush) {
 		FPRINTF(outStream, "%s%s\n", framePrefix, record);
 
 		if (flush)
@@ -132,8 +309,10 @@ namespace log_file {
 
 	/**
 	 * Writes to the individual log files, if they do want to log the section.
+	 * Records that already carry their frame prefix pass an empty one, they
+	 * are flushed by the caller.
 	 */
-	void writeToFiles(int level, const char* section, const char* record)
+	void writeToFiles(int level, const char* section, const char* framePrefix, const char* record, bool flush)
 	{
 		const auto& logFiles = getLogFiles();
 
@@ -143,10 +322,18 @@ namespace log_file {
 			if (p.second.GetOutStream() == nullptr)
 				continue;
 
-			writeToFile(p.second.GetOutStream(), record, p.second.FlushOnWrite(level));
+			writeToFile(p.second.GetOutStream(), framePrefix, record, flush && p.second.FlushOnWrite(level));
 		}
 	}
 
+	void writeToFiles(int level, const char* section, const char* record)
+	{
+		char framePrefix[128] = {'\0'};
+		log_framePrefixer_createPrefix(framePrefix, sizeof(framePrefix));
+
+		writeToFiles(level, section, framePrefix, record, true);
+	}
+
 	/**
 	 * Flushes the buffers of the individual log files.
 	 */
@@ -184,6 +371,137 @@ namespace log_file {
 
 		logRecords.emplace_back(level, section, record);
 	}
+
+
+	/**
+	 * Writes all published records of the async queue to the log files,
+	 * then flushes them once. Caller must be the (only) consumer.
+	 */
+	size_t writeQueueToFiles(AsyncWriter& writer) {
+		AsyncRecordQueue::RecordHeader header;
+		size_t numRecords = 0;
+
+		while (writer.queue->TryPop(header, writer.buffer)) {
+			const char* section = writer.buffer.data();
+			const char* record = section + header.sectionLength + 1;
+
+			writeToFiles(header.level, section, "", record, false);
+			numRecords += 1;
+		}
+
+		if (numRecords > 0)
+			flushFiles();
+
+		return numRecords;
+	}
+
+	/**
+	 * Records are formatted and frame-prefixed by the logging thread, so the
+	 * writer thread only has to copy them out.
+	 */
+	void writeToQueue(AsyncWriter& writer, int level, const char* section, const char* record)
+	{
+		char framePrefix[128] = {'\0'};
+		log_framePrefixer_createPrefix(framePrefix, sizeof(framePrefix));
+
+		while (!writer.queue->TryPush(level, section, framePrefix, record)) {
+			// queue is full; help drain it instead of waiting for the writer thread
+			if (writer.threadId.load() != std::this_thread::get_id() && filesMutex.try_lock()) {
+				writeQueueToFiles(writer);
+				filesMutex.unlock();
+			} else {
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	/**
+	 * Writes out the records queued so far without blocking for longer than
+	 * <maxWait>; also safe to call from a crash-handler. Records that were
+	 * claimed but never published (eg. by a crashed thread) are not waited
+	 * for.
+	 */
+	void flushQueue(AsyncWriter& writer, std::chrono::milliseconds maxWait) {
+		if (writer.queue == nullptr)
+			return;
+
+		// writer thread itself (crashed), already holds the lock
+		if (writer.threadId.load() == std::this_thread::get_id()) {
+			writeQueueToFiles(writer);
+			return;
+		}
+
+		const auto deadline = std::chrono::steady_clock::now() + maxWait;
+
+		do {
+			if (filesMutex.try_lock()) {
+				writeQueueToFiles(writer);
+				filesMutex.unlock();
+				return;
+			}
+
+			std::this_thread::yield();
+		} while (std::chrono::steady_clock::now() < deadline);
+	}
+
+	void runAsyncWriter(AsyncWriter* writer) {
+		writer->threadId.store(std::this_thread::get_id());
+
+		while (writer->running.load(std::memory_order_acquire)) {
+			size_t numRecords = 0;
+
+			{
+				std::lock_guard<std::mutex> lock(filesMutex);
+				numRecords = writeQueueToFiles(*writer);
+			}
+
+			// batch up records while idle
+			if (numRecords == 0)
+				std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+	}
+
+	void startAsyncWriter() {
+		AsyncWriter& writer = getAsyncWriter();
+
+		if (writer.running.load())
+			return;
+
+		if (writer.queue == nullptr)
+			writer.queue = std::make_unique<AsyncRecordQueue>();
+
+		{
+			std::lock_guard<std::mutex> lock(filesMutex);
+			writeBufferToFiles();
+		}
+
+		writer.running.store(true);
+		writer.thread = std::thread(runAsyncWriter, &writer);
+		writer.enabled.store(true);
+	}
+
+	void stopAsyncWriter() {
+		AsyncWriter& writer = getAsyncWriter();
+
+		if (!writer.running.load())
+			return;
+
+		writer.enabled.store(false);
+
+		// producers that still saw the flag set must finish their push before
+		// the final drain; the writer thread keeps running so a full queue can
+		// not stall them
+		while (writer.numPushing.load() != 0) {
+			std::this_thread::yield();
+		}
+
+		writer.running.store(false);
+		writer.thread.join();
+		writer.threadId.store({});
+
+		std::lock_guard<std::mutex> lock(filesMutex);
+		writeQueueToFiles(writer);
+	}
 }
 
 
@@ -220,6 +538,8 @@ void log_file_addLogFile(
 
 	setvbuf(tmpStream, nullptr, _IOFBF, std::min(BUFSIZ, 8192)); // limit buffer to 8kB
 
+	std::lock_guard<std::mutex> lock(log_file::filesMutex);
+
 	logFiles.emplace_back(filePathStr, log_file::LogFileDetails(tmpStream, sectionsStr, minLevel, flushLevel));
 
 	// swap into position; only a handful of files are ever added
@@ -243,6 +563,8 @@ void log_file_removeLogFile(const char* filePath) {
 	if (iter == logFiles.end() || strcmp(iter->first.c_str(), filePath) != 0)
 		return;
 
+	std::lock_guard<std::mutex> lock(log_file::filesMutex);
+
 	// turn off logging to this file
 	fclose(iter->second.GetOutStream());
 
@@ -258,6 +580,8 @@ void log_file_removeLogFile(const char* filePath) {
 void log_file_removeAllLogFiles() {
 	auto& logFiles = log_file::getLogFiles();
 
+	log_file::stopAsyncWriter();
+
 	for (auto& logFilePair: logFiles) {
 		fclose(logFilePair.second.GetOutStream());
 	}
@@ -280,6 +604,15 @@ FILE* log_file_getLogFileStream(const char* filePath) {
 }
 
 
+void log_file_setAsyncWrite(bool enable) {
+	if (enable) {
+		log_file::startAsyncWriter();
+	} else {
+		log_file::stopAsyncWriter();
+	}
+}
+
+
 
 /**
  * @name logging_sink_file
@@ -291,6 +624,23 @@ FILE* log_file_getLogFileStream(const char* filePath) {
 static void log_sink_record_file(int level, const char* section, const char* record)
 {
 	if (log_file::validTracker && log_file::isActivelyLogging()) {
+		log_file::AsyncWriter& asyncWriter = log_file::getAsyncWriter();
+
+		// hand over to the writer thread; announce the push before checking
+		// the flag again so stopAsyncWriter either waits for it or we write
+		// synchronously below
+		if (asyncWriter.enabled.load(std::memory_order_relaxed)) {
+			asyncWriter.numPushing.fetch_add(1);
+
+			if (asyncWriter.enabled.load()) {
+				log_file::writeToQueue(asyncWriter, level, section, record);
+				asyncWriter.numPushing.fetch_sub(1);
+				return;
+			}
+
+			asyncWriter.numPushing.fetch_sub(1);
+		}
+
 		// write buffer to log file
 		log_file::writeBufferToFiles();
 
@@ -304,6 +654,12 @@ static void log_sink_record_file(int level, const char* section, const char* rec
 
 /// Cleans up all log streams, by flushing them.
 static void log_sink_cleanup_file() {
+	if (!log_file::validTracker)
+		return;
+
+	// bounded, this also runs from crash-handlers
+	log_file::flushQueue(log_file::getAsyncWriter(), std::chrono::milliseconds(500));
+
 	if (!log_file::isActivelyLogging())
 		return;
 
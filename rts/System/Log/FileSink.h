@@ -41,6 +41,15 @@ void log_file_removeLogFile(const char* filePath);
 
 void log_file_removeAllLogFiles();
 
+/**
+ * Move writing (and flushing) the log files to a dedicated thread.
+ * Records are still formatted by the thread that logs them, but then only
+ * copied into a lock-free queue; the writer thread drains it in batches.
+ * Pending records are written out (with a bounded wait) by LOG_CLEANUP().
+ * Disabling it writes all queued records before returning.
+ */
+void log_file_setAsyncWrite(bool enable);
+
 ///@}
 
 #ifdef __cplusplus
@@ -44,6 +44,10 @@ CONFIG(int, LogRepeatLimit)
 	.defaultValue(10)
 	.description("Allow at most this many consecutive identical messages to be logged.");
 
+CONFIG(bool, LogAsyncWrite)
+	.defaultValue(false)
+	.description("Write the logfile from a dedicated thread instead of the logging one. Reduces stalls from verbose log sections, but records still pending on a hard crash can be lost.");
+
 /******************************************************************************/
 /******************************************************************************/
 
@@ -173,6 +177,7 @@ void CLogOutput::Initialize()
 
 	log_filter_setRepeatLimit(configHandler->GetInt("LogRepeatLimit")); // all sinks
 	log_file_addLogFile(filePath.c_str(), nullptr, LOG_LEVEL_ALL, configHandler->GetInt("LogFlushLevel"));
+	log_file_setAsyncWrite(configHandler->GetBool("LogAsyncWrite"));
 
 	LOG("LogOutput initialized. Logging to %s", filePath.c_str());
 }
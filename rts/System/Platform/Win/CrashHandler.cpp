@@ -401,6 +401,9 @@ void PrepareStacktrace(const int logLevel) {
 	EnterCriticalSection(&stackLock);
 	InitImageHlpDll();
 
+	// write out records still queued for the log-writer thread first
+	LOG_CLEANUP();
+
 	// sidestep any kind of hidden allocation which might cause a deadlock
 	// this does mean the "[f=123456] Error:" prefixes will not be present
 	logFile = log_file_getLogFileStream((logOutput.GetFilePath()).c_str());
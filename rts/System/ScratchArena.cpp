@@ -0,0 +1,147 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "ScratchArena.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "System/SpringMem.h"
+#include "System/Misc/TracyDefs.h"
+
+static const char* const scratchAllocsPlot = "ScratchArenaAllocs";
+static const char* const scratchBytesPlot = "ScratchArenaBytes";
+
+std::array<spring::ScratchArena, ThreadPool::MAX_THREADS> spring::ScratchArena::arenas;
+
+size_t spring::ScratchArena::frameAllocs = 0;
+size_t spring::ScratchArena::frameBytes = 0;
+
+
+static inline size_t AlignUp(size_t value, size_t alignment)
+{
+	return ((value + alignment - 1) & ~(alignment - 1));
+}
+
+
+void* spring::ScratchArena::Allocate(size_t size, size_t alignment)
+{
+	assert(alignment <= BLOCK_ALIGNMENT);
+
+	numAllocs += 1;
+	numBytes += size;
+
+	if (blockIdx < blocks.size()) {
+		const size_t start = AlignUp(offset, alignment);
+
+		if ((start + size) <= blocks[blockIdx].size) {
+			offset = start + size;
+			return (blocks[blockIdx].mem + start);
+		}
+	}
+
+	return (AllocateFromNextBlock(size));
+}
+
+void* spring::ScratchArena::AllocateFromNextBlock(size_t size)
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	const size_t nextIdx = blockIdx + (blockIdx < blocks.size() && offset > 0);
+
+	// blocks past the current one are unused, take the next if it is large
+	// enough or put a new one in front of it (each at least twice the last)
+	if (nextIdx >= blocks.size() || blocks[nextIdx].size < size) {
+		const size_t prevSize = blocks.empty()? 0: blocks.back().size;
+		const size_t blockSize = AlignUp(std::max({MIN_BLOCK_SIZE, prevSize * 2, size}), BLOCK_ALIGNMENT);
+
+		Block block = {static_cast<std::byte*>(spring::AllocateAlignedMemory(blockSize, BLOCK_ALIGNMENT)), blockSize};
+		blocks.insert(blocks.begin() + std::min(nextIdx, blocks.size()), block);
+	}
+
+	// blocks start out maximally aligned, no padding needed
+	blockIdx = nextIdx;
+	offset = size;
+
+	return (blocks[blockIdx].mem);
+}
+
+void spring::ScratchArena::Deallocate(void* ptr, size_t size)
+{
+	if (ptr == nullptr || blockIdx >= blocks.size())
+		return;
+
+	const std::byte* top = blocks[blockIdx].mem + offset;
+
+	if ((static_cast<const std::byte*>(ptr) + size) != top)
+		return;
+
+	offset -= size;
+}
+
+void spring::ScratchArena::Rewind(const Mark& mark)
+{
+	assert(mark.blockIdx < blocks.size() || (mark.blockIdx == 0 && mark.offset == 0));
+
+	blockIdx = mark.blockIdx;
+	offset = mark.offset;
+}
+
+void spring::ScratchArena::Reset()
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+	blockIdx = 0;
+	offset = 0;
+
+	if (blocks.size() <= 1)
+		return;
+
+	// one contiguous block means no more block switches next frame
+	const size_t capacity = GetCapacity();
+
+	FreeBlocks();
+	blocks.push_back({static_cast<std::byte*>(spring::AllocateAlignedMemory(capacity, BLOCK_ALIGNMENT)), capacity});
+}
+
+size_t spring::ScratchArena::GetCapacity() const
+{
+	size_t capacity = 0;
+
+	for (const Block& block: blocks) {
+		capacity += block.size;
+	}
+
+	return capacity;
+}
+
+void spring::ScratchArena::FreeBlocks()
+{
+	for (Block& block: blocks) {
+		spring::FreeAlignedMemory(block.mem);
+	}
+
+	blocks.clear();
+}
+
+
+void spring::ScratchArena::ResetAll()
+{
+	RECOIL_DETAILED_TRACY_ZONE;
+#ifdef THREADPOOL
+	assert(!ThreadPool::inMultiThreadedSection);
+#endif
+
+	frameAllocs = 0;
+	frameBytes = 0;
+
+	for (ScratchArena& arena: arenas) {
+		frameAllocs += arena.numAllocs;
+		frameBytes += arena.numBytes;
+
+		arena.numAllocs = 0;
+		arena.numBytes = 0;
+
+		arena.Reset();
+	}
+
+	TracyPlot(scratchAllocsPlot, static_cast<int64_t>(frameAllocs));
+	TracyPlot(scratchBytesPlot, static_cast<int64_t>(frameBytes));
+}
@@ -0,0 +1,137 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "System/Threading/ThreadPool.h"
+
+namespace spring {
+	/**
+	 * Per-thread monotonic arena for short-lived sim temporaries (query results,
+	 * target lists, ...). Allocations only bump a pointer and are never freed
+	 * individually; a Scope rewinds the arena when it goes out of scope and the
+	 * whole arena is reset once per sim frame (see CGame::SimFrame).
+	 *
+	 * Containers using it must be function-locals owned by the thread that
+	 * created them, never members or anything else surviving the frame.
+	 */
+	class ScratchArena {
+	public:
+		struct Mark {
+			size_t blockIdx = 0;
+			size_t offset = 0;
+		};
+
+		// restores the arena to its state at construction on destruction,
+		// declare it before the containers allocating from the arena
+		class Scope {
+		public:
+			Scope(): Scope(ScratchArena::Get()) {}
+			explicit Scope(ScratchArena& arena_): arena(arena_), mark(arena_.GetMark()) {}
+			~Scope() { arena.Rewind(mark); }
+
+			Scope(const Scope&) = delete;
+			Scope& operator = (const Scope&) = delete;
+
+		private:
+			ScratchArena& arena;
+			Mark mark;
+		};
+
+	public:
+		ScratchArena() = default;
+		~ScratchArena() { FreeBlocks(); }
+
+		ScratchArena(const ScratchArena&) = delete;
+		ScratchArena& operator = (const ScratchArena&) = delete;
+
+		void* Allocate(size_t size, size_t alignment);
+		// only the most recent allocation is given back (e.g. a vector that
+		// is shrunk or destroyed right away), anything else waits for a rewind
+		void Deallocate(void* ptr, size_t size);
+
+		Mark GetMark() const { return {blockIdx, offset}; }
+		void Rewind(const Mark& mark);
+
+		// rewinds to the start and merges all blocks into one big enough for
+		// the peak usage so far; no allocation from the arena may be alive
+		void Reset();
+
+		size_t GetNumAllocs() const { return numAllocs; }
+		size_t GetNumBytes() const { return numBytes; }
+		size_t GetCapacity() const;
+
+		// arena of the calling (pool) thread
+		static ScratchArena& Get() { return arenas[ThreadPool::GetThreadNum()]; }
+
+		// called at the end of each sim frame, outside of any for_mt section
+		static void ResetAll();
+
+		// totals over all threads for the last completed frame
+		static size_t GetFrameAllocs() { return frameAllocs; }
+		static size_t GetFrameBytes() { return frameBytes; }
+
+	private:
+		struct Block {
+			std::byte* mem;
+			size_t size;
+		};
+
+		void* AllocateFromNextBlock(size_t size);
+		void FreeBlocks();
+
+	private:
+		static constexpr size_t MIN_BLOCK_SIZE = 64 * 1024;
+		static constexpr size_t BLOCK_ALIGNMENT = 64;
+
+		std::vector<Block> blocks;
+
+		size_t blockIdx = 0;
+		size_t offset = 0;
+
+		// per-frame statistics, reset by ResetAll
+		size_t numAllocs = 0;
+		size_t numBytes = 0;
+
+		static std::array<ScratchArena, ThreadPool::MAX_THREADS> arenas;
+
+		static size_t frameAllocs;
+		static size_t frameBytes;
+	};
+
+
+	template<typename T>
+	class ScratchAllocator {
+	public:
+		using value_type = T;
+
+		ScratchAllocator(): arena(&ScratchArena::Get()) {}
+		explicit ScratchAllocator(ScratchArena& arena_): arena(&arena_) {}
+
+		template<typename U>
+		ScratchAllocator(const ScratchAllocator<U>& other): arena(other.GetArena()) {}
+
+		T* allocate(size_t n) { return static_cast<T*>(arena->Allocate(n * sizeof(T), alignof(T))); }
+		void deallocate(T* ptr, size_t n) { arena->Deallocate(ptr, n * sizeof(T)); }
+
+		ScratchArena* GetArena() const { return arena; }
+
+		template<typename U>
+		bool operator == (const ScratchAllocator<U>& other) const { return (arena == other.GetArena()); }
+		template<typename U>
+		bool operator != (const ScratchAllocator<U>& other) const { return (arena != other.GetArena()); }
+
+	private:
+		ScratchArena* arena;
+	};
+
+	template<typename T>
+	using scratch_vector = std::vector<T, ScratchAllocator<T>>;
+}
+
+#endif // SCRATCH_ARENA_H
@@ -3,6 +3,7 @@
 #include <functional>
 #include <iostream>
 #include <chrono>
+#include <utility>
 
 #include <SDL.h>
 #include <System/GflagsExt.h>
@@ -103,6 +104,8 @@
 
 
 CONFIG(unsigned, SetCoreAffinity).defaultValue(0).safemodeValue(1).description("Defines a bitmask indicating which CPU cores the main-thread should use.");
+CONFIG(bool, BitmapDecodeCache).defaultValue(false).description("Keep decoded copies of loaded images in the cache directory, repeated loads of the same image then skip decoding at the cost of disk space");
+CONFIG(unsigned, BitmapDecodeCacheSize).defaultValue(1024).minimumValue(16).description("Maximum size of the bitmap decode cache in MB, the least recently used entries are removed at startup once it grows larger.");
 CONFIG(unsigned, TextureMemPoolSize).defaultValue(512).minimumValue(0).description("Set to 0 to disable, otherwise specify a predefined memory to serve Bitmap allocation requests");
 CONFIG(bool, UseLuaMemPools).defaultValue(true).description("Whether Lua VM memory allocations are made from pools.");
 CONFIG(bool, UseHighResTimer).defaultValue(false).description("On Windows, sets whether Spring will use low- or high-resolution timer functions for tasks like graphical interpolation between game frames.");
@@ -111,6 +114,7 @@ CONFIG(bool, UseFontConfigSystemFonts).defaultValue(true).description("Whether t
 CONFIG(bool, FontConfigSearchAttributes).defaultValue(true).description("Whether the font characteristics will used to refine the search by fontconfig. Results in better glyph matches in some cases, but has a nontrivial performance cost.");
 CONFIG(bool, FontConfigApplySubstitutions).defaultValue(true).description("[EXPERIMENTAL] In case it's disabled FcConfigSubstitute is not getting called, this might break non-ASCII font rendering.");
 CONFIG(int, MaxFontTries).defaultValue(5).description("Represents the maximum number of attempts to search for a glyph replacement using the FontConfig library (lower = foreign glyphs may fail to render, higher = searching for foreign glyphs can lag the game).");
+CONFIG(bool, FontGlyphCache).defaultValue(true).description("Whether rasterized font glyphs should be stored in the cache directory and reused by later runs, avoids stutter when text in a new script (eg. CJK) is first shown.");
 CONFIG(int, MaxPinnedFonts).defaultValue(10).description("Maximum number of fonts to pin to cache. Increasing this will eventually use more memory, but can alleviate processing spikes when rendering new glyphs.");
 
 CONFIG(std::string, name).defaultValue(UnnamedPlayerName).description("Sets your name in the game. Since this is overridden by lobbies with your lobby username when playing, it usually only comes up when viewing replays or starting the engine directly for testing purposes.");
@@ -267,6 +271,7 @@ bool SpringApp::Init()
 
 	CCameraHandler::InitStatic();
 	CBitmap::InitPool(configHandler->GetInt("TextureMemPoolSize"));
+	CBitmap::InitDecodeCache(configHandler->GetBool("BitmapDecodeCache"), configHandler->GetUnsigned("BitmapDecodeCacheSize"));
 
 	UpdateInterfaceGeometry();
 	InitFonts();
@@ -913,8 +918,8 @@ int SpringApp::Run()
 			Watchdog::ClearTimer(WDT_MAIN);
 			input.PushEvents();
 
-			// move to clear global data if a save is queued
-			ILoadSaveHandler::CreateSave(std::move(globalSaveFileData));
+			// exchange to clear global data (incl. the keyframe flag) if a save is queued
+			ILoadSaveHandler::CreateSave(std::exchange(globalSaveFileData, {}));
 
 			if (gu->globalReload) {
 				// copy; reloadScript is cleared by ResetState
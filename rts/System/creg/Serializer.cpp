@@ -79,14 +79,24 @@ static void WriteZStr(std::ostream& file, const std::string& str)
 }
 
 
+// the varint helpers and raw (de)serialization are called for every single
+// member, so they talk to the stream-buffer directly and skip the per-call
+// sentry objects of std::istream::read and std::ostream::write
 template<typename T>
 void ReadVarSizeUInt(std::istream* stream, T* buf)
 {
+	std::streambuf* sbuf = stream->rdbuf();
 	std::uint64_t val = 0;
 	unsigned offset = 0;
 	while (true) {
-		unsigned char a;
-		stream->read((char*)&a, sizeof(char));
+		const int c = sbuf->sbumpc();
+
+		if (c == std::char_traits<char>::eof()) {
+			stream->setstate(std::ios::eofbit | std::ios::failbit);
+			break;
+		}
+
+		const unsigned char a = c;
 
 		val += ((std::uint64_t)(a & 0x7F)) << offset;
 		if ((a & 0x80) == 0)
@@ -102,6 +112,8 @@ template<typename T>
 void WriteVarSizeUInt(std::ostream* stream, T val)
 {
 	std::uint64_t v = val;
+	unsigned char bytes[10];
+	std::streamsize numBytes = 0;
 	do {
 		unsigned char a = v & 0x7F;
 		v >>= 7;
@@ -109,8 +121,11 @@ void WriteVarSizeUInt(std::ostream* stream, T val)
 		if (v > 0)
 			a |= 0x80;
 
-		stream->write((char*)&a, sizeof(char));
+		bytes[numBytes++] = a;
 	} while (v > 0);
+
+	if (stream->rdbuf()->sputn((const char*)bytes, numBytes) != numBytes)
+		stream->setstate(std::ios::badbit);
 }
 
 void creg::ReadUInt(std::istream* stream, std::uint64_t* buf)
@@ -138,59 +153,64 @@ bool COutputStreamSerializer::IsWriting()
 
 COutputStreamSerializer::ObjectRef* COutputStreamSerializer::FindObjectRef(void* inst, creg::Class* objClass, bool isEmbedded)
 {
-	std::vector<ObjectRef*>& refs = ptrToId[inst];
-	for (auto& obj: refs) {
+	const auto it = ptrToId.find(inst);
+
+	if (it == ptrToId.end())
+		return nullptr;
+
+	for (ObjectRef* obj = it->second; obj != nullptr; obj = obj->nextRef) {
 		if (obj->isThisObject(inst, objClass, isEmbedded))
 			return obj;
 	}
 	return nullptr;
 }
 
+COutputStreamSerializer::ObjectRef* COutputStreamSerializer::AddObjectRef(void* inst, creg::Class* objClass, bool isEmbedded)
+{
+	objects.emplace_back(inst, objects.size(), isEmbedded, objClass);
+
+	ObjectRef* obj = &objects.back();
+	ObjectRef*& ref = ptrToId[inst];
+
+	// keep registration order, the first object at an address is its container
+	if (ref == nullptr) {
+		ref = obj;
+	} else {
+		ObjectRef* lastRef = ref;
+
+		while (lastRef->nextRef != nullptr)
+			lastRef = lastRef->nextRef;
+
+		lastRef->nextRef = obj;
+	}
+
+	return obj;
+}
+
 void COutputStreamSerializer::SerializeObject(Class* c, void* ptr, ObjectRef* objr)
 {
-	const unsigned objstart = stream->tellp();
+	const unsigned objstart = collectSizes? unsigned(stream->tellp()): 0;
 
 	if (c->base())
 		SerializeObject(c->base(), ptr, objr);
 
-	ObjectMemberGroup omg;
-	omg.membersClass = c;
-	omg.size = 0;
-
 	for (uint a = 0; a < c->members.size(); a++)
 	{
 		creg::Class::Member* m = &c->members[a];
 		if (m->flags & CM_NoSerialize)
 			continue;
 
-		ObjectMember om;
-		om.member = m;
-		om.memberId = a;
 		void* memberAddr = ((char*)ptr) + m->offset;
-		unsigned mstart = stream->tellp();
 		LOG_SL(LOG_SECTION_CREG_SERIALIZER, L_DEBUG, "Serialized %s::%s type:%s", c->name, m->name, m->type->GetName().c_str());
 		m->type->Serialize(this, memberAddr);
-		unsigned mend = stream->tellp();
-		om.size = mend - mstart;
-		omg.members.push_back(om);
-		omg.size += om.size;
-		LOG_SL(LOG_SECTION_CREG_SERIALIZER, L_DEBUG, "Serialized %s::%s type:%s size:%d", c->name, m->name, m->type->GetName().c_str(), om.size);
 	}
 
 
-	if (c->HasSerialize()) {
-		ObjectMember om;
-		om.member = nullptr;
-		om.memberId = -1;
-		unsigned mstart = stream->tellp();
+	if (c->HasSerialize())
 		c->CallSerializeProc(ptr, this);
-		unsigned mend = stream->tellp();
-		om.size = mend - mstart;
-		omg.members.push_back(om);
-		omg.size += om.size;
-	}
 
-	objr->memberGroups.push_back(omg);
+	if (!collectSizes)
+		return;
 
 	const unsigned objend = stream->tellp();
 	const int sz = objend - objstart;
@@ -203,18 +223,14 @@ void COutputStreamSerializer::SerializeObjectInstance(void* inst, creg::Class* o
 	// register the object, and mark it as embedded if a pointer was already referencing it
 	ObjectRef* obj = FindObjectRef(inst, objClass, true);
 	if (!obj) {
-		objects.emplace_back(inst, objects.size(), true, objClass);
-		obj = &objects.back();
-		ptrToId[inst].push_back(obj);
+		obj = AddObjectRef(inst, objClass, true);
 	} else if (obj->isEmbedded) {
 		throw std::string("Reserialization of embedded object (") + objClass->name + ")";
+	} else if (!obj->isPending) {
+		throw std::string("Object pointer was serialized (") + objClass->name + ")";
 	} else {
-		std::vector<ObjectRef*>::iterator it = std::find(pendingObjects.begin(), pendingObjects.end(), obj);
-		if (it == pendingObjects.end()) {
-			throw std::string("Object pointer was serialized (") + objClass->name + ")";
-		} else {
-			pendingObjects.erase(it);
-		}
+		// still queued, will be skipped now that it is embedded
+		obj->isPending = false;
 	}
 	obj->class_ = objClass;
 	obj->isEmbedded = true;
@@ -233,9 +249,8 @@ void COutputStreamSerializer::SerializeObjectPtr(void** ptr, creg::Class* objCla
 		int id;
 		ObjectRef* obj = FindObjectRef(*ptr, objClass, false);
 		if (!obj) {
-			objects.emplace_back(*ptr, objects.size(), false, objClass);
-			obj = &objects.back();
-			ptrToId[*ptr].push_back(obj);
+			obj = AddObjectRef(*ptr, objClass, false);
+			obj->isPending = true;
 			pendingObjects.push_back(obj);
 		}
 		id = obj->id;
@@ -249,7 +264,8 @@ void COutputStreamSerializer::SerializeObjectPtr(void** ptr, creg::Class* objCla
 
 void COutputStreamSerializer::Serialize(void* data, int byteSize)
 {
-	stream->write((char*)data, byteSize);
+	if (stream->rdbuf()->sputn((const char*)data, byteSize) != byteSize)
+		stream->setstate(std::ios::badbit);
 }
 
 void COutputStreamSerializer::SerializeInt(void* data, int byteSize)
@@ -282,6 +298,7 @@ void COutputStreamSerializer::SavePackage(std::ostream* s, void* rootObj, Class*
 	PackageHeader ph;
 
 	stream = s;
+	collectSizes = LOG_IS_ENABLED_S(LOG_SECTION_CREG_SERIALIZER, L_DEBUG);
 	unsigned startOffset = stream->tellp();
 	stream->write((char*)&ph, sizeof(PackageHeader));
 	stream->seekp(startOffset + sizeof(PackageHeader));
@@ -293,18 +310,28 @@ void COutputStreamSerializer::SavePackage(std::ostream* s, void* rootObj, Class*
 	obj->classIndex = 0;
 
 	// Insert the first object that will provide references to everything
-	objects.emplace_back(rootObj, objects.size(), false, rootObjClass);
-	obj = &objects.back();
-	ptrToId[rootObj].push_back(obj);
+	obj = AddObjectRef(rootObj, rootObjClass, false);
+	obj->isPending = true;
 	pendingObjects.push_back(obj);
 
+	std::vector<ObjectRef*> po;
+
 	// Save until all the referenced objects have been stored
 	while (!pendingObjects.empty())
 	{
-		const std::vector<ObjectRef*> po = pendingObjects;
-		pendingObjects.clear();
+		po.clear();
+		po.swap(pendingObjects);
+
+		// objects of this batch can no longer turn into embedded ones
+		for (ObjectRef* obj: po) {
+			obj->isPending = false;
+		}
 
 		for (ObjectRef* obj: po) {
+			// was serialized as an embedded instance after being queued
+			if (obj->isEmbedded)
+				continue;
+
 			SerializeObject(obj->class_, obj->ptr, obj);
 			//LOG_SL(LOG_SECTION_CREG_SERIALIZER, L_DEBUG, "Serialized %s size:%i", obj->class_->name.c_str(), sz);
 		}
@@ -334,9 +361,9 @@ void COutputStreamSerializer::SavePackage(std::ostream* s, void* rootObj, Class*
 	}
 
 
-	if (LOG_IS_ENABLED(L_DEBUG)) {
+	if (collectSizes) {
 		for (auto &it: classSizes) {
-			LOG_L(L_DEBUG, "%30s %10u %10u",
+			LOG_SL(LOG_SECTION_CREG_SERIALIZER, L_DEBUG, "%30s %10u %10u",
 					it.first->name,
 					classCounts[it.first],
 					it.second);
@@ -373,7 +400,7 @@ void COutputStreamSerializer::SavePackage(std::ostream* s, void* rootObj, Class*
 			const auto it = ptrToId.find(container);
 			if (container == nullptr || it == ptrToId.end())
 				throw std::string("Preallocation container of (") + oRef.class_->name + ") doesn't exist";
-			ObjectRef* objCont = it->second.front();
+			ObjectRef* objCont = it->second;
 			// write container ID and offset of placement-new location
 			WriteVarSizeUInt(stream, objCont->id);
 			WriteVarSizeUInt(stream, (char*)oRef.ptr - (char*)container);
@@ -438,8 +465,14 @@ void CInputStreamSerializer::SerializeObject(Class* c, void* ptr)
 		if (m->flags & CM_NoSerialize)
 			continue;
 
-		const unsigned oldPos = stream->tellg();
 		void* memberAddr = ((char*)ptr) + m->offset;
+
+		if (!LOG_IS_ENABLED_S(LOG_SECTION_CREG_SERIALIZER, L_DEBUG)) {
+			m->type->Serialize(this, memberAddr);
+			continue;
+		}
+
+		const unsigned oldPos = stream->tellg();
 		m->type->Serialize(this, memberAddr);
 		LOG_SL(LOG_SECTION_CREG_SERIALIZER, L_DEBUG, "Deserialized %s::%s type:%s size:%u", c->name, m->name, m->type->GetName().c_str(), unsigned(stream->tellg()) - oldPos);
 	}
@@ -451,7 +484,8 @@ void CInputStreamSerializer::SerializeObject(Class* c, void* ptr)
 
 void CInputStreamSerializer::Serialize(void* data, int byteSize)
 {
-	stream->read((char*)data, byteSize);
+	if (stream->rdbuf()->sgetn((char*)data, byteSize) != byteSize)
+		stream->setstate(std::ios::eofbit | std::ios::failbit);
 }
 
 void CInputStreamSerializer::SerializeInt(void* data, int byteSize)
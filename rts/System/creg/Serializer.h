@@ -13,6 +13,8 @@
 #include <deque>
 #include <istream>
 
+#include "System/UnorderedMap.hpp"
+
 namespace creg {
 
 	/**
@@ -23,43 +25,32 @@ namespace creg {
 	class COutputStreamSerializer : public ISerializer
 	{
 	protected:
-		struct ObjectMember {
-			Class::Member* member;
-			int memberId;
-			int size;
-		};
-		struct ObjectMemberGroup {
-			Class* membersClass;
-			std::vector<COutputStreamSerializer::ObjectMember> members;
-			int size;
-		};
 		struct ObjectRef {
 			ObjectRef() {
 				ptr = 0;
 				id=0;
 				classIndex=0;
 				isEmbedded=false;
+				isPending=false;
 				class_=0;
+				nextRef=0;
 			}
 			ObjectRef(void* ptr, int id, bool isEmbedded, Class* class_) {
 				this->ptr = ptr;
 				this->id=id;
 				classIndex=0;
 				this->isEmbedded=isEmbedded;
+				isPending=false;
 				this->class_=class_;
-			}
-			ObjectRef(const ObjectRef&src) :memberGroups(src.memberGroups){
-				ptr=src.ptr;
-				id=src.id;
-				classIndex=src.classIndex;
-				isEmbedded=src.isEmbedded;
-				class_=src.class_;
+				nextRef=0;
 			}
 			void* ptr;
 			int id, classIndex;
 			bool isEmbedded;
+			bool isPending;
 			Class* class_;
-			std::vector<COutputStreamSerializer::ObjectMemberGroup> memberGroups;
+			// next object registered at the same address (eg. an embedded first member)
+			ObjectRef* nextRef;
 			bool isThisObject(void* objPtr, Class* objClass, bool objEmbedded) const
 			{
 				if (ptr != objPtr) return false;
@@ -81,18 +72,22 @@ namespace creg {
 		struct ClassRef;
 
 		std::ostream* stream;
-		std::map<void*,std::vector<ObjectRef*> > ptrToId;
+		spring::unsynced_map<const void*, ObjectRef*> ptrToId; // first object registered at each address
 		std::deque<ObjectRef> objects;
 		std::vector<ObjectRef*> pendingObjects; // these objects still have to be saved
 		std::map<Class*, int> classSizes;
 		std::map<Class*, int> classCounts;
 
+		// per-object size statistics, only gathered for debug output
+		bool collectSizes = false;
+
 		// Serialize all class names
 		void WriteObjectInfo();
 		// Helper for instance/ptr saving
 		void WriteObjectRef(void* inst, Class* cls, bool embedded);
 
 		ObjectRef* FindObjectRef(void* inst, Class* objClass, bool isEmbedded);
+		ObjectRef* AddObjectRef(void* inst, Class* objClass, bool isEmbedded);
 
 		void SerializeObject(Class* c, void* ptr, ObjectRef* objr);
 
@@ -0,0 +1,89 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "ExternalAI/AISimThreadTasks.h"
+#include "ExternalAI/SkirmishAIHandler.h"
+#include "System/Threading/ThreadPool.h"
+#include "System/Misc/SpringTime.h"
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <catch_amalgamated.hpp>
+
+
+struct do_once {
+	do_once() { Threading::DetectCores(); } // make GetMaxThreads() work
+};
+
+InitSpringTime ist;
+do_once doonce;
+
+
+namespace {
+	struct SimTask {
+		uint8_t senderAIId;
+		uint8_t taskAIId;
+		std::thread::id threadId;
+	};
+
+	static constexpr uint8_t NUM_AIS = 8;
+	static constexpr int NUM_TASKS_PER_AI = 16;
+}
+
+
+TEST_CASE("SimTasksRunAsSendingAI")
+{
+	// without workers the updates run on this thread and the tasks directly
+	ThreadPool::SetThreadCount(ThreadPool::GetMaxThreads());
+
+	// only touched on the sim thread
+	std::vector<SimTask> simTasks;
+	std::vector<std::function<void()>> updates;
+
+	for (uint8_t aiId = 0; aiId < NUM_AIS; aiId++) {
+		updates.emplace_back([&simTasks, aiId]() {
+			// as done by CSkirmishAILibrary::HandleEvent on the worker thread
+			CSkirmishAIHandler::SetCurrentAIID(aiId);
+
+			for (int i = 0; i < NUM_TASKS_PER_AI; i++) {
+				AISimThreadTasks::RunOnSimThread([&simTasks, aiId]() {
+					simTasks.push_back({aiId, CSkirmishAIHandler::GetCurrentAIID(), std::this_thread::get_id()});
+				});
+
+				if (CSkirmishAIHandler::GetCurrentAIID() != aiId)
+					throw std::runtime_error("worker lost its AI id");
+			}
+
+			CSkirmishAIHandler::SetCurrentAIID(MAX_AIS);
+		});
+	}
+
+	CSkirmishAIHandler::SetCurrentAIID(MAX_AIS);
+	AISimThreadTasks::RunUpdates(updates);
+
+	CHECK(!AISimThreadTasks::InThreadedUpdate());
+	CHECK(CSkirmishAIHandler::GetCurrentAIID() == MAX_AIS);
+	REQUIRE(simTasks.size() == (NUM_AIS * NUM_TASKS_PER_AI));
+
+	for (const SimTask& simTask: simTasks) {
+		CHECK(simTask.taskAIId == simTask.senderAIId);
+		CHECK(simTask.threadId == std::this_thread::get_id());
+	}
+
+	ThreadPool::SetThreadCount(0);
+}
+
+TEST_CASE("UpdateExceptionsAreRethrown")
+{
+	ThreadPool::SetThreadCount(ThreadPool::GetMaxThreads());
+
+	std::vector<std::function<void()>> updates;
+	updates.emplace_back([]() { AISimThreadTasks::RunOnSimThread([]() {}); });
+	updates.emplace_back([]() { throw std::runtime_error("update failed"); });
+
+	CHECK_THROWS_AS(AISimThreadTasks::RunUpdates(updates), std::runtime_error);
+	CHECK(CSkirmishAIHandler::GetCurrentAIID() == MAX_AIS);
+
+	ThreadPool::SetThreadCount(0);
+}
@@ -0,0 +1,199 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+// Texture atlas packing harness: feeds a synthetic set of projectile-like
+// textures through every IAtlasAllocator, validates the placements and
+// reports atlas size, fill ratio and allocation time. Tune via the environment
+// (ATLAS_BENCH_ENTRIES, ATLAS_BENCH_SEED) to compare allocator changes
+// without a GPU.
+
+#include "Rendering/Textures/LegacyAtlasAlloc.h"
+#include "Rendering/Textures/QuadtreeAtlasAlloc.h"
+#include "Rendering/Textures/RowAtlasAlloc.h"
+#include "Rendering/Textures/SkylineAtlasAlloc.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch_amalgamated.hpp>
+
+namespace {
+	static int GetEnvInt(const char* name, int defValue)
+	{
+		const char* value = std::getenv(name);
+
+		if (value == nullptr)
+			return defValue;
+
+		return std::max(1, std::atoi(value));
+	}
+
+	static std::vector<int2> GenerateEntrySizes(int numEntries, uint32_t seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> potDist(3, 7);
+		std::uniform_int_distribution<int> npotDist(8, 200);
+		std::uniform_int_distribution<int> kindDist(0, 3);
+
+		std::vector<int2> sizes;
+		sizes.reserve(numEntries);
+
+		// mostly power-of-two sprites plus some odd-sized ones, like the
+		// textures listed in resources.lua of a typical game
+		for (int i = 0; i < numEntries; ++i) {
+			switch (kindDist(rng)) {
+				case 0: { sizes.emplace_back(1 << potDist(rng), 1 << potDist(rng)); } break;
+				case 1: { sizes.emplace_back(npotDist(rng), npotDist(rng)); } break;
+				default: {
+					const int s = 1 << potDist(rng);
+					sizes.emplace_back(s, s);
+				} break;
+			}
+		}
+
+		return sizes;
+	}
+
+	struct Rect {
+		int x1, y1;
+		int x2, y2;
+	};
+
+	struct PackResult {
+		int2 atlasSize;
+		int64_t usedArea = 0;
+		double allocTime = 0.0;
+		bool allocated = false;
+		bool valid = true;
+	};
+
+	// <inclusive> tells whether texCoords.x2/y2 are the last texel or one past it
+	static PackResult Pack(IAtlasAllocator& allocator, const std::vector<int2>& sizes, bool inclusive, int padding)
+	{
+		PackResult result;
+
+		allocator.SetMaxSize(4096, 4096);
+
+		for (size_t i = 0; i < sizes.size(); ++i) {
+			allocator.AddEntry("tex" + std::to_string(i), sizes[i]);
+			result.usedArea += int64_t(sizes[i].x) * sizes[i].y;
+		}
+
+		const auto t0 = std::chrono::steady_clock::now();
+		result.allocated = allocator.Allocate();
+		const auto t1 = std::chrono::steady_clock::now();
+
+		result.atlasSize = allocator.GetAtlasSize();
+		result.allocTime = std::chrono::duration<double, std::micro>(t1 - t0).count();
+
+		std::vector<Rect> rects;
+		rects.reserve(sizes.size());
+
+		for (const auto& [name, entry]: allocator.GetEntries()) {
+			const Rect rect = {
+				int(entry.texCoords.x1),
+				int(entry.texCoords.y1),
+				int(entry.texCoords.x1) + entry.size.x,
+				int(entry.texCoords.y1) + entry.size.y,
+			};
+
+			result.valid &= ((int(entry.texCoords.x2) + inclusive) == rect.x2);
+			result.valid &= ((int(entry.texCoords.y2) + inclusive) == rect.y2);
+			result.valid &= (rect.x1 >= 0 && rect.y1 >= 0);
+			result.valid &= (rect.x2 <= result.atlasSize.x && rect.y2 <= result.atlasSize.y);
+
+			rects.push_back(rect);
+		}
+
+		// entries (grown by the padding when checked) may never overlap
+		for (size_t i = 0; i < rects.size(); ++i) {
+			for (size_t j = i + 1; j < rects.size(); ++j) {
+				const Rect& a = rects[i];
+				const Rect& b = rects[j];
+
+				result.valid &= ((a.x2 + padding) <= b.x1 || (b.x2 + padding) <= a.x1 || (a.y2 + padding) <= b.y1 || (b.y2 + padding) <= a.y1);
+			}
+		}
+
+		return result;
+	}
+
+	static void PrintResult(const char* allocName, const PackResult& result)
+	{
+		const int64_t atlasArea = int64_t(result.atlasSize.x) * result.atlasSize.y;
+		const double fillRatio = (atlasArea > 0)? (double(result.usedArea) / atlasArea): 0.0;
+
+		printf("[AtlasAllocBench::%s] atlas=%dx%d fill=%.1f%% time=%.1fus\n", allocName, result.atlasSize.x, result.atlasSize.y, fillRatio * 100.0, result.allocTime);
+	}
+}
+
+
+TEST_CASE("AtlasAlloc")
+{
+	const int numEntries = GetEnvInt("ATLAS_BENCH_ENTRIES", 256);
+	const int seed       = GetEnvInt("ATLAS_BENCH_SEED",    1234);
+
+	const std::vector<int2> sizes = GenerateEntrySizes(numEntries, seed);
+
+	CLegacyAtlasAlloc legacyAlloc;
+	CQuadtreeAtlasAlloc quadtreeAlloc;
+	CRowAtlasAlloc rowAlloc;
+	CSkylineAtlasAlloc skylineAlloc;
+
+	// legacy and row keep their padding only between some neighbours, skyline everywhere
+	const int skylinePadding = 1 << skylineAlloc.GetNumTexLevels();
+
+	const PackResult legacyResult   = Pack(  legacyAlloc, sizes,  true, 0);
+	const PackResult quadtreeResult = Pack(quadtreeAlloc, sizes,  true, 0);
+	const PackResult rowResult      = Pack(     rowAlloc, sizes, false, 0);
+	const PackResult skylineResult  = Pack( skylineAlloc, sizes,  true, skylinePadding);
+
+	PrintResult("legacy",   legacyResult);
+	PrintResult("quadtree", quadtreeResult);
+	PrintResult("row",      rowResult);
+	PrintResult("skyline",  skylineResult);
+
+	CHECK(skylineResult.allocated);
+	CHECK(skylineResult.valid);
+
+	// the allocators the skyline one replaces must still produce sane atlases
+	CHECK(legacyResult.allocated);
+	CHECK(legacyResult.valid);
+	CHECK(quadtreeResult.allocated);
+	CHECK(quadtreeResult.valid);
+	CHECK(rowResult.allocated);
+	CHECK(rowResult.valid);
+
+	{
+		const int64_t legacyArea  = int64_t( legacyResult.atlasSize.x) *  legacyResult.atlasSize.y;
+		const int64_t skylineArea = int64_t(skylineResult.atlasSize.x) * skylineResult.atlasSize.y;
+
+		INFO("skyline atlas is larger than the legacy one");
+		CHECK(skylineArea <= legacyArea);
+	}
+
+	// placement must be reproducible, reloadable atlases rely on it
+	CSkylineAtlasAlloc skylineAlloc2;
+	const PackResult skylineResult2 = Pack(skylineAlloc2, sizes, true, skylinePadding);
+
+	CHECK(skylineResult2.valid);
+
+	bool sameLayout = (skylineResult2.atlasSize == skylineResult.atlasSize);
+
+	for (const auto& [name, entry]: skylineAlloc.GetEntries()) {
+		const float4 texCoords = skylineAlloc2.GetEntry(name);
+
+		sameLayout &= (texCoords.x1 == entry.texCoords.x1 && texCoords.y1 == entry.texCoords.y1);
+	}
+
+	CHECK(sameLayout);
+
+	// allocating again must not grow the atlas, reloadable atlases call it repeatedly
+	skylineAlloc.Allocate();
+	CHECK(skylineAlloc.GetAtlasSize() == skylineResult.atlasSize);
+}
@@ -0,0 +1,147 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Sim/Misc/InterceptorGrid.h"
+#include "System/float3.h"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <catch_amalgamated.hpp>
+
+namespace {
+	struct Interceptor {
+		float3 pos;
+		float radius;
+	};
+
+	struct Interceptable {
+		float3 pos;
+		float3 dir;
+		float3 targetPos;
+	};
+
+	// geometric part of CInterceptHandler::CanIntercept: all of its cases imply
+	// that the coverage circle contains the target or a point of the 2D ray
+	// (the same ray as CInterceptHandler::Update hands to the grid)
+	static bool IsInRange(const Interceptor& w, const Interceptable& p)
+	{
+		if (w.pos.SqDistance2D(p.targetPos) < (w.radius * w.radius))
+			return true;
+
+		const float3 rayPos = p.pos - p.dir;
+		const float3 rayDir = p.dir * XZVector;
+		const float3 wVec = (w.pos - rayPos) * XZVector;
+
+		const float rayLenSq = rayDir.SqLength();
+		const float t = (rayLenSq > 0.0f)? std::max(0.0f, wVec.dot(rayDir) / rayLenSq): 0.0f;
+
+		return ((rayPos + rayDir * t).SqDistance2D(w.pos) < (w.radius * w.radius));
+	}
+
+	struct Scenario {
+		Scenario(unsigned int seed) {
+			std::mt19937 rng(seed);
+			std::uniform_int_distribution<int> sizeDist(1, 16);
+			std::uniform_int_distribution<int> caseDist(0, 7);
+			std::uniform_real_distribution<float> unitDist(0.0f, 1.0f);
+			std::uniform_real_distribution<float> dirDist(-1.0f, 1.0f);
+
+			// real maps are multiples of the cell size, odd sizes test the padded last cells
+			mapSizeX = sizeDist(rng) * CInterceptorGrid::CELL_SIZE - ((seed & 1) * 100.0f);
+			mapSizeZ = sizeDist(rng) * CInterceptorGrid::CELL_SIZE - ((seed & 2) * 50.0f);
+
+			// positions mostly on the map, some up to a quarter beyond its edges
+			const auto RandPos = [&]() {
+				return float3((unitDist(rng) * 1.5f - 0.25f) * mapSizeX, unitDist(rng) * 500.0f, (unitDist(rng) * 1.5f - 0.25f) * mapSizeZ);
+			};
+
+			for (int i = 0; i < 64; i++) {
+				interceptors.push_back({RandPos(), 50.0f + unitDist(rng) * 1500.0f});
+			}
+
+			for (int i = 0; i < 256; i++) {
+				Interceptable p = {RandPos(), float3(dirDist(rng), dirDist(rng), dirDist(rng)), RandPos()};
+
+				// axis-aligned and vertical flight take the special paths of the ray walk
+				switch (caseDist(rng)) {
+					case 0: { p.dir.x = 0.0f; } break;
+					case 1: { p.dir.z = 0.0f; } break;
+					case 2: { p.dir.x = 0.0f; p.dir.z = 0.0f; } break;
+					default: {} break;
+				}
+
+				if (p.dir.SqLength() == 0.0f)
+					p.dir = -UpVector;
+
+				p.dir.ANormalize();
+				interceptables.push_back(p);
+			}
+		}
+
+		float mapSizeX;
+		float mapSizeZ;
+
+		std::vector<Interceptor> interceptors;
+		std::vector<Interceptable> interceptables;
+	};
+}
+
+
+TEST_CASE("InterceptorGridMatchesBruteForce")
+{
+	size_t numCandidates = 0;
+	size_t numBruteForce = 0;
+
+	for (unsigned int seed = 0; seed < 64; seed++) {
+		const Scenario s(seed);
+
+		// the old nested loop, interceptor-major
+		std::vector< std::pair<int, int> > bruteForcePairs;
+
+		for (size_t j = 0; j < s.interceptors.size(); j++) {
+			for (size_t i = 0; i < s.interceptables.size(); i++) {
+				if (IsInRange(s.interceptors[j], s.interceptables[i]))
+					bruteForcePairs.emplace_back(j, i);
+			}
+		}
+
+		// as done by CInterceptHandler::Update
+		CInterceptorGrid grid;
+		grid.Reset(s.mapSizeX, s.mapSizeZ);
+
+		for (size_t j = 0; j < s.interceptors.size(); j++) {
+			grid.AddInterceptor(j, s.interceptors[j].pos, s.interceptors[j].radius);
+		}
+
+		std::vector< std::pair<int, int> > gridPairs;
+		std::vector<int> candidates;
+
+		for (size_t i = 0; i < s.interceptables.size(); i++) {
+			const Interceptable& p = s.interceptables[i];
+
+			grid.GetCandidates(p.targetPos, p.pos - p.dir, p.dir * XZVector, candidates);
+
+			CHECK(std::is_sorted(candidates.begin(), candidates.end()));
+			CHECK(std::adjacent_find(candidates.begin(), candidates.end()) == candidates.end());
+
+			for (const int j: candidates) {
+				if (IsInRange(s.interceptors[j], p))
+					gridPairs.emplace_back(j, i);
+			}
+
+			numCandidates += candidates.size();
+		}
+
+		std::sort(gridPairs.begin(), gridPairs.end());
+
+		numBruteForce += (s.interceptors.size() * s.interceptables.size());
+
+		INFO("seed " << seed << " map " << s.mapSizeX << "x" << s.mapSizeZ);
+		REQUIRE(gridPairs == bruteForcePairs);
+	}
+
+	// the grid has to actually prune something
+	CHECK(numCandidates < numBruteForce);
+}
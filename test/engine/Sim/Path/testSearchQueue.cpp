@@ -0,0 +1,120 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "Sim/Path/QTPFS/SearchQueue.h"
+
+#include <queue>
+#include <random>
+#include <vector>
+
+#include <catch_amalgamated.hpp>
+
+using namespace QTPFS;
+
+typedef ShouldMoveTowardsBottomOfPriorityQueue NodeCmp;
+typedef std::priority_queue<SearchQueueNode, std::vector<SearchQueueNode>, NodeCmp> StdQueue;
+
+namespace {
+	// mimics a search: each popped node pushes a few neighbours with higher
+	// priorities, and priorities repeat often enough to exercise the index
+	// tie-break the queue ordering relies on
+	template<typename TQueue>
+	static void RunSearchPattern(TQueue& queue, std::vector<SearchQueueNode>& popped, unsigned int seed, int numPops)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<int> stepDist(0, 16);
+		std::uniform_int_distribution<int> countDist(0, 7);
+		std::uniform_int_distribution<int> indexDist(0, 1 << 16);
+
+		queue.emplace(0, 0.0f);
+
+		for (int n = 0; n < numPops && !queue.empty(); n++) {
+			const SearchQueueNode node = queue.top();
+			queue.pop();
+			popped.push_back(node);
+
+			for (int i = countDist(rng); i > 0; i--) {
+				queue.emplace(indexDist(rng), node.heapPriority + stepDist(rng) * 0.5f);
+			}
+		}
+	}
+
+	template<size_t D>
+	static void CheckPopOrder(unsigned int seed)
+	{
+		DAryHeap<SearchQueueNode, NodeCmp, D> heap;
+		StdQueue queue;
+
+		std::vector<SearchQueueNode> heapPopped;
+		std::vector<SearchQueueNode> queuePopped;
+
+		RunSearchPattern(heap, heapPopped, seed, 20000);
+		RunSearchPattern(queue, queuePopped, seed, 20000);
+
+		REQUIRE(heapPopped.size() == queuePopped.size());
+		REQUIRE(heap.size() == queue.size());
+
+		for (size_t i = 0; i < heapPopped.size(); i++) {
+			CHECK(heapPopped[i].nodeIndex == queuePopped[i].nodeIndex);
+			CHECK(heapPopped[i].heapPriority == queuePopped[i].heapPriority);
+		}
+	}
+}
+
+
+TEST_CASE("SearchQueuePopOrder")
+{
+	// synced searches must not depend on which queue a build picked
+	for (unsigned int seed = 0; seed < 8; seed++) {
+		CheckPopOrder<2>(seed);
+		CheckPopOrder<4>(seed);
+		CheckPopOrder<8>(seed);
+	}
+}
+
+TEST_CASE("SearchQueueClear")
+{
+	DAryHeap<SearchQueueNode, NodeCmp, 4> heap;
+
+	for (int i = 0; i < 100; i++) {
+		heap.emplace(i, float(100 - i));
+	}
+
+	CHECK(heap.size() == 100);
+	CHECK(heap.top().nodeIndex == 99);
+
+	heap.clear();
+	CHECK(heap.empty());
+
+	// still a valid heap after being cleared
+	heap.emplace(1, 2.0f);
+	heap.emplace(2, 1.0f);
+	heap.emplace(0, 1.0f);
+
+	CHECK(heap.top().nodeIndex == 0);
+	heap.pop();
+	CHECK(heap.top().nodeIndex == 2);
+	heap.pop();
+	CHECK(heap.top().nodeIndex == 1);
+	heap.pop();
+	CHECK(heap.empty());
+}
+
+TEST_CASE("SearchQueueBenchmark")
+{
+	std::vector<SearchQueueNode> popped;
+	popped.reserve(20000);
+
+	BENCHMARK("std::priority_queue") {
+		StdQueue queue;
+		popped.clear();
+		RunSearchPattern(queue, popped, 0, 20000);
+		return popped.size();
+	};
+
+	BENCHMARK("DAryHeap<4>") {
+		DAryHeap<SearchQueueNode, NodeCmp, 4> heap;
+		popped.clear();
+		RunSearchPattern(heap, popped, 0, 20000);
+		return popped.size();
+	};
+}
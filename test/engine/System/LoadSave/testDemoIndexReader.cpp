@@ -0,0 +1,197 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/FileSystem/GZipMember.h"
+#include "System/LoadSave/DemoIndexReader.h"
+#include "System/LoadSave/demofile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+#include <catch_amalgamated.hpp>
+
+
+namespace {
+	// laid out like CDemoRecorder writes it: header, stream chunks, statistics, index, footer
+	struct TestDemo {
+		std::vector<std::string> chunkData = {std::string(1000, 'a'), std::string(3000, 'b'), std::string(10, 'c')};
+		std::string statsData = std::string(64, 's');
+
+		std::vector<DemoIndexChunk> chunks;
+		DemoIndexFooter footer;
+
+		void Write(const char* filePath) {
+			FILE* file = fopen(filePath, "wb");
+			REQUIRE(file != nullptr);
+
+			DemoFileHeader header;
+			memset(&header, 0, sizeof(header));
+			strcpy(header.magic, DEMOFILE_MAGIC);
+			header.version = DEMOFILE_VERSION;
+			header.headerSize = sizeof(header);
+			header.swab();
+
+			std::uint32_t fileOffset = GZipMember::CompressAndWrite(file, &header, sizeof(header), Z_NO_COMPRESSION);
+			std::uint32_t streamOffset = sizeof(header);
+
+			chunks.clear();
+
+			for (size_t i = 0; i < chunkData.size(); i++) {
+				DemoIndexChunk chunk;
+				memset(&chunk, 0, sizeof(chunk));
+
+				chunk.fileOffset = fileOffset;
+				chunk.fileSize = GZipMember::CompressAndWrite(file, chunkData[i].data(), chunkData[i].size(), 5);
+				chunk.streamOffset = streamOffset;
+				chunk.streamSize = chunkData[i].size();
+				chunk.firstFrame = i * 100;
+				chunk.lastFrame = i * 100 + 99;
+				chunk.AddPacketType(i + 1);
+
+				chunks.push_back(chunk);
+
+				fileOffset += chunk.fileSize;
+				streamOffset += chunk.streamSize;
+			}
+
+			memset(&footer, 0, sizeof(footer));
+			strcpy(footer.magic, DEMOINDEX_MAGIC);
+			footer.version = DEMOINDEX_VERSION;
+			footer.footerSize = sizeof(footer);
+			footer.numChunks = chunks.size();
+
+			footer.statsFileOffset = fileOffset;
+			footer.statsFileSize = GZipMember::CompressAndWrite(file, statsData.data(), statsData.size(), 5);
+			footer.indexFileOffset = footer.statsFileOffset + footer.statsFileSize;
+
+			std::vector<DemoIndexChunk> index = chunks;
+
+			for (DemoIndexChunk& chunk: index) {
+				chunk.swab();
+			}
+
+			footer.indexFileSize = GZipMember::CompressAndWrite(file, index.data(), index.size() * sizeof(DemoIndexChunk), 5);
+
+			DemoIndexFooter swabbedFooter = footer;
+			swabbedFooter.swab();
+
+			GZipMember::CompressAndWrite(file, &swabbedFooter, sizeof(swabbedFooter), Z_NO_COMPRESSION);
+			fclose(file);
+		}
+	};
+
+	static std::vector<std::uint8_t> ReadFile(const char* filePath) {
+		std::vector<std::uint8_t> data;
+		FILE* file = fopen(filePath, "rb");
+
+		if (file == nullptr)
+			return data;
+
+		fseek(file, 0, SEEK_END);
+		data.resize(ftell(file));
+		fseek(file, 0, SEEK_SET);
+
+		if (fread(data.data(), 1, data.size(), file) != data.size())
+			data.clear();
+
+		fclose(file);
+		return data;
+	}
+
+	static void WriteFile(const char* filePath, const std::vector<std::uint8_t>& data) {
+		FILE* file = fopen(filePath, "wb");
+		REQUIRE(file != nullptr);
+		fwrite(data.data(), 1, data.size(), file);
+		fclose(file);
+	}
+
+	static constexpr const char* TEST_DEMO_NAME = "testDemoIndexReader.sdfz";
+}
+
+
+TEST_CASE("DemoIndexRead")
+{
+	TestDemo demo;
+	demo.Write(TEST_DEMO_NAME);
+
+	{
+		CDemoIndexReader reader(TEST_DEMO_NAME);
+
+		REQUIRE(reader.IsValid());
+
+		const DemoIndexFooter& footer = reader.GetFooter();
+
+		CHECK(footer.numChunks == int(demo.chunkData.size()));
+		CHECK(footer.statsFileOffset == demo.footer.statsFileOffset);
+		CHECK(footer.statsFileSize == demo.footer.statsFileSize);
+		CHECK(footer.indexFileOffset == demo.footer.indexFileOffset);
+		CHECK(footer.indexFileSize == demo.footer.indexFileSize);
+
+		REQUIRE(reader.GetChunks().size() == demo.chunks.size());
+
+		std::vector<std::uint8_t> data;
+
+		for (size_t i = 0; i < demo.chunks.size(); i++) {
+			const DemoIndexChunk& chunk = reader.GetChunks()[i];
+
+			CHECK(chunk.fileOffset == demo.chunks[i].fileOffset);
+			CHECK(chunk.fileSize == demo.chunks[i].fileSize);
+			CHECK(chunk.streamOffset == demo.chunks[i].streamOffset);
+			CHECK(chunk.streamSize == demo.chunks[i].streamSize);
+
+			REQUIRE(reader.ReadChunk(i, data));
+			CHECK(std::string(data.begin(), data.end()) == demo.chunkData[i]);
+		}
+
+		REQUIRE(reader.ReadStats(data));
+		CHECK(std::string(data.begin(), data.end()) == demo.statsData);
+
+		DemoFileHeader header;
+		REQUIRE(reader.ReadFileHeader(header));
+		CHECK(strcmp(header.magic, DEMOFILE_MAGIC) == 0);
+
+		CHECK(reader.FindChunks(150, 250) == std::vector<size_t>{1, 2});
+		CHECK(reader.FindChunks(0, 1000, 3) == std::vector<size_t>{2});
+		CHECK(!reader.ReadChunk(demo.chunks.size(), data));
+	}
+
+	remove(TEST_DEMO_NAME);
+}
+
+TEST_CASE("DemoIndexCorrupt")
+{
+	TestDemo demo;
+	demo.Write(TEST_DEMO_NAME);
+
+	const std::vector<std::uint8_t> fileData = ReadFile(TEST_DEMO_NAME);
+	REQUIRE(!fileData.empty());
+
+	SECTION("truncated footer") {
+		WriteFile(TEST_DEMO_NAME, {fileData.begin(), fileData.end() - 4});
+		CHECK(!CDemoIndexReader(TEST_DEMO_NAME).IsValid());
+	}
+
+	SECTION("corrupt footer") {
+		std::vector<std::uint8_t> corruptData = fileData;
+		// inside the footer's magic, after the stored member's 15 bytes of headers
+		corruptData[corruptData.size() - 8 - sizeof(DemoIndexFooter)] ^= 0xFF;
+
+		WriteFile(TEST_DEMO_NAME, corruptData);
+		CHECK(!CDemoIndexReader(TEST_DEMO_NAME).IsValid());
+	}
+
+	SECTION("no index") {
+		// demos of crashed games end after the last stream chunk
+		WriteFile(TEST_DEMO_NAME, {fileData.begin(), fileData.begin() + demo.footer.statsFileOffset});
+		CHECK(!CDemoIndexReader(TEST_DEMO_NAME).IsValid());
+	}
+
+	SECTION("missing file") {
+		remove(TEST_DEMO_NAME);
+		CHECK(!CDemoIndexReader(TEST_DEMO_NAME).IsValid());
+	}
+
+	remove(TEST_DEMO_NAME);
+}
@@ -7,7 +7,11 @@
 #include <catch_amalgamated.hpp>
 
 #include <cstdarg>
+#include <cstring>
+#include <fstream>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 
 
@@ -231,3 +235,70 @@ TEST_CASE("IsEnabled")
 	TLOG_SL(   "other-one-time-section", L_DEBUG, "Testing LOG_IS_ENABLED_S");
 }
 
+
+TEST_CASE("AsyncFileWrite")
+{
+	static constexpr int NUM_THREADS = 4;
+	static constexpr int NUM_RECORDS = 2000;
+
+	const std::string logFile = ls.GetTempLogFile();
+
+	// the stream sink is not thread-safe
+	log_sink_stream_setLogStream(NULL);
+	log_file_addLogFile(logFile.c_str());
+	log_file_setAsyncWrite(true);
+
+	std::vector<std::thread> threads;
+
+	for (int t = 0; t < NUM_THREADS; t++) {
+		threads.emplace_back([t]() {
+			// records of varying size, some span many queue slots
+			const std::string padding(1000 + t * 500, '-');
+
+			for (int i = 0; i < NUM_RECORDS; i++) {
+				LOG("async %d %d %s", t, i, padding.c_str() + (i * 7) % 1000);
+			}
+		});
+	}
+	for (std::thread& thread: threads) {
+		thread.join();
+	}
+
+	// writes out everything still queued
+	log_file_setAsyncWrite(false);
+	log_file_removeLogFile(logFile.c_str());
+	log_sink_stream_setLogStream(&ls.logStream);
+
+	std::ifstream logFileStream(logFile);
+	std::string line;
+	std::vector<int> nextRecords(NUM_THREADS, 0);
+
+	int numRecords = 0;
+	bool badRecord = false;
+
+	while (std::getline(logFileStream, line)) {
+		const size_t pos = line.find("] async ");
+
+		if (pos == std::string::npos)
+			continue;
+
+		int t = -1;
+		int i = -1;
+		char padding[4096] = {0};
+
+		if (sscanf(line.c_str() + pos, "] async %d %d %4095s", &t, &i, padding) != 3 || t < 0 || t >= NUM_THREADS) {
+			badRecord = true;
+			continue;
+		}
+
+		// records of one thread must stay in order and arrive complete
+		badRecord |= (i != nextRecords[t]++);
+		badRecord |= (strlen(padding) != size_t(1000 + t * 500 - (i * 7) % 1000));
+		numRecords += 1;
+	}
+
+	remove(logFile.c_str());
+
+	CHECK(numRecords == NUM_THREADS * NUM_RECORDS);
+	CHECK_FALSE(badRecord);
+}
@@ -0,0 +1,92 @@
+/* This file is part of the Spring engine (GPL v2 or later), see LICENSE.html */
+
+#include "System/ScratchArena.h"
+
+#include <cstdint>
+#include <numeric>
+
+#include <catch_amalgamated.hpp>
+
+using spring::ScratchArena;
+
+
+TEST_CASE("ScratchArenaAlignment")
+{
+	ScratchArena arena;
+
+	for (size_t alignment = 1; alignment <= 64; alignment *= 2) {
+		arena.Allocate(1, 1);
+
+		const void* ptr = arena.Allocate(alignment, alignment);
+		CHECK((reinterpret_cast<uintptr_t>(ptr) % alignment) == 0);
+	}
+
+	CHECK(arena.GetNumAllocs() == 14);
+}
+
+TEST_CASE("ScratchArenaScope")
+{
+	ScratchArena arena;
+
+	const void* outer = arena.Allocate(128, 16);
+	const ScratchArena::Mark mark = arena.GetMark();
+
+	{
+		ScratchArena::Scope scope(arena);
+		spring::scratch_vector<int> ints{spring::ScratchAllocator<int>(arena)};
+
+		// force growth past the first block
+		ints.resize(1024 * 1024);
+		std::iota(ints.begin(), ints.end(), 0);
+
+		CHECK(ints.back() == (1024 * 1024 - 1));
+		CHECK(arena.GetCapacity() > (1024 * 1024 * sizeof(int)));
+	}
+
+	CHECK(arena.GetMark().blockIdx == mark.blockIdx);
+	CHECK(arena.GetMark().offset == mark.offset);
+
+	// next allocation continues right after the one made before the scope
+	const void* next = arena.Allocate(16, 16);
+	CHECK(next == (static_cast<const std::byte*>(outer) + 128));
+}
+
+TEST_CASE("ScratchArenaDeallocateTop")
+{
+	ScratchArena arena;
+
+	void* a = arena.Allocate(64, 8);
+	void* b = arena.Allocate(64, 8);
+
+	// not the most recent allocation, stays in place
+	arena.Deallocate(a, 64);
+	CHECK(arena.Allocate(8, 8) == (static_cast<std::byte*>(b) + 64));
+
+	arena.Rewind({0, 128});
+	arena.Deallocate(b, 64);
+	CHECK(arena.Allocate(64, 8) == b);
+}
+
+TEST_CASE("ScratchArenaReset")
+{
+	ScratchArena arena;
+
+	for (int i = 0; i < 16; ++i) {
+		arena.Allocate(48 * 1024, 16);
+	}
+
+	const size_t capacity = arena.GetCapacity();
+
+	// blocks are merged into one, the next frame fits without switching
+	arena.Reset();
+	CHECK(arena.GetCapacity() == capacity);
+
+	const void* first = arena.Allocate(16, 16);
+
+	for (int i = 0; i < 15; ++i) {
+		arena.Allocate(48 * 1024, 16);
+	}
+
+	CHECK(arena.GetMark().blockIdx == 0);
+	CHECK(first != nullptr);
+}
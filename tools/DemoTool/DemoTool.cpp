@@ -9,6 +9,7 @@
 #include "StringSerializer.h"
 
 #include "Net/Protocol/BaseNetProtocol.h"
+#include "System/LoadSave/DemoIndexReader.h"
 #include "System/LoadSave/DemoReader.h"
 #include "System/Net/RawPacket.h"
 #include "Sim/Units/CommandAI/Command.h"
@@ -28,6 +29,7 @@ no console output (you still could use this.exe > z.tzt though).
 	DEFINE_bool  (dump,         false, "Only dump networc traffic saved in demo");
 	DEFINE_bool  (stats,        false, "Print all game, player and team stats");
 	DEFINE_bool  (header,       false, "Print demoheader content");
+	DEFINE_bool  (index,        false, "Print the demo index (chunk offsets, frames and packet types)");
 	DEFINE_bool  (playerstats,  false, "Print playerstats");
 	DEFINE_bool  (teamstats,    false, "Print teamstats");
 	DEFINE_int32 (team,         -1,    "Select team");
@@ -35,6 +37,7 @@ no console output (you still could use this.exe > z.tzt though).
 
 
 void TrafficDump(CDemoReader& reader, bool trafficStats);
+int PrintIndex(const std::string& filename);
 void WriteTeamstatHistory(CDemoReader& reader, unsigned team, const std::string& file);
 
 int main (int argc, char* argv[])
@@ -52,6 +55,10 @@ int main (int argc, char* argv[])
 		gflags::ShowUsageWithFlags(argv[0]);
 	}
 
+	// does not need to decompress the whole demo
+	if (FLAGS_index)
+		return PrintIndex(filename);
+
 	CDemoReader reader(filename, 0.0f);
 	reader.LoadStats();
 	if (FLAGS_dump)
@@ -190,6 +197,39 @@ void PrintBinary(const unsigned char* const buf, int len)
 	std::cout << std::dec; //reset to decimal
 }
 
+int PrintIndex(const std::string& filename)
+{
+	CDemoIndexReader indexReader(filename);
+
+	if (!indexReader.IsValid()) {
+		std::cout << "Demo has no index (older engine or unfinished game)" << std::endl;
+		return 1;
+	}
+
+	const DemoIndexFooter& footer = indexReader.GetFooter();
+	const std::vector<DemoIndexChunk>& chunks = indexReader.GetChunks();
+
+	std::cout << "Chunks: " << footer.numChunks << std::endl;
+	std::cout << "Statistics: file offset " << footer.statsFileOffset << " (" << footer.statsFileSize << " bytes)" << std::endl;
+
+	for (unsigned i = 0; i < chunks.size(); ++i) {
+		const DemoIndexChunk& chunk = chunks[i];
+
+		std::cout << "Chunk " << i << ": frames " << chunk.firstFrame << "-" << chunk.lastFrame;
+		std::cout << ", file offset " << chunk.fileOffset << " (" << chunk.fileSize << " bytes)";
+		std::cout << ", stream offset " << chunk.streamOffset << " (" << chunk.streamSize << " bytes), packet types:";
+
+		for (unsigned type = 0; type < NETMSG_LAST; ++type) {
+			if (chunk.HasPacketType(type))
+				std::cout << " " << type;
+		}
+
+		std::cout << std::endl;
+	}
+
+	return 0;
+}
+
 void TrafficDump(CDemoReader& reader, bool trafficStats)
 {
 	InitCommandNames();